@@ -0,0 +1,140 @@
+#include "bench.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <reflector/json.hh>
+#include <reflector/macros.hh>
+
+namespace rf::bench
+{
+REFL_MAKE_INTROSPECTABLE(result, name, variant, ns_per_op, iterations, relative);
+REFL_MAKE_INTROSPECTABLE(size_result, name, variant, bytes_per_op, relative);
+
+struct all_results
+{
+    cc::vector<result> const& timings;
+    cc::vector<size_result> const& sizes;
+};
+REFL_MAKE_INTROSPECTABLE(all_results, timings, sizes);
+}
+
+namespace
+{
+void print_usage(char const* exe)
+{
+    std::printf("usage: %s [options]\n", exe);
+    std::printf("  --filter <text>      only run benchmarks whose name contains text (can be repeated)\n");
+    std::printf("  --min-time <ms>      minimal measured time per variant (default: 200)\n");
+    std::printf("  --repetitions <n>    number of measured batches, the fastest is reported (default: 5)\n");
+    std::printf("  --json               print results as JSON instead of CSV\n");
+}
+}
+
+bool rf::bench::context::parse_args(int argc, char** argv)
+{
+    for (auto i = 1; i < argc; ++i)
+    {
+        auto const arg = argv[i];
+        auto const has_value = i + 1 < argc;
+
+        if (std::strcmp(arg, "--filter") == 0 && has_value)
+            _filters.push_back(cc::string(argv[++i]));
+        else if (std::strcmp(arg, "--min-time") == 0 && has_value)
+            _min_time_ns = std::atof(argv[++i]) * 1e6;
+        else if (std::strcmp(arg, "--repetitions") == 0 && has_value)
+            _repetitions = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--json") == 0)
+            _json = true;
+        else
+        {
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (_repetitions < 1 || !(_min_time_ns > 0))
+    {
+        print_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+bool rf::bench::context::is_enabled(cc::string const& name) const
+{
+    if (_filters.empty())
+        return true;
+
+    for (auto const& f : _filters)
+        if (std::strstr(name.c_str(), f.c_str()) != nullptr)
+            return true;
+    return false;
+}
+
+void rf::bench::context::add_result(cc::string const& name, char const* variant, timing t, timing baseline)
+{
+    _results.push_back(result{name, variant, t.ns_per_op, t.iterations, t.ns_per_op / baseline.ns_per_op});
+
+    // progress for interactive runs, results themselves go to stdout
+    std::fprintf(stderr, "%-40s %-10s %12.2f ns\n", name.c_str(), variant, t.ns_per_op);
+}
+
+void rf::bench::context::report_size(char const* operation, char const* subject, double op_bytes, double baseline_bytes, double raw_bytes)
+{
+    cc::string name = operation;
+    name += '/';
+    name += subject;
+    if (!is_enabled(name))
+        return;
+
+    add_size_result(name, "reflector", op_bytes, baseline_bytes);
+    add_size_result(name, "baseline", baseline_bytes, baseline_bytes);
+    add_size_result(name, "raw", raw_bytes, baseline_bytes);
+}
+
+void rf::bench::context::add_size_result(cc::string const& name, char const* variant, double bytes, double baseline_bytes)
+{
+    _size_results.push_back(size_result{name, variant, bytes, bytes / baseline_bytes});
+
+    std::fprintf(stderr, "%-40s %-10s %12.2f B\n", name.c_str(), variant, bytes);
+}
+
+void rf::bench::context::print_results() const
+{
+    if (_json)
+    {
+        std::printf("%s\n", rf::to_json(all_results{_results, _size_results}).c_str());
+        return;
+    }
+
+    std::printf("benchmark,variant,ns_per_op,iterations,relative_to_baseline\n");
+    for (auto const& r : _results)
+        std::printf("%s,%s,%.3f,%llu,%.3f\n", r.name.c_str(), r.variant, r.ns_per_op, (unsigned long long)r.iterations, r.relative);
+
+    // sizes are a separate table (after an empty line) since they have different columns
+    if (!_size_results.empty())
+    {
+        std::printf("\nbenchmark,variant,bytes_per_op,relative_to_baseline\n");
+        for (auto const& r : _size_results)
+            std::printf("%s,%s,%.2f,%.3f\n", r.name.c_str(), r.variant, r.bytes_per_op, r.relative);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    rf::bench::context ctx;
+    if (!ctx.parse_args(argc, argv))
+        return 1;
+
+    rf::bench::run_compare_benchmarks(ctx);
+    rf::bench::run_string_benchmarks(ctx);
+    rf::bench::run_enum_benchmarks(ctx);
+    rf::bench::run_serialize_benchmarks(ctx);
+    rf::bench::run_sort_benchmarks(ctx);
+    rf::bench::run_member_benchmarks(ctx);
+
+    ctx.print_results();
+    return 0;
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <clean-core/string.hh>
+#include <clean-core/vector.hh>
+
+namespace rf::bench
+{
+/**
+ * Minimal benchmark harness for reflector-bench
+ *
+ * Every benchmark measures a reflector operation against a hand-written baseline doing the same work
+ * Results are written as one row per variant (CSV by default, JSON with --json), see bench.cc for all options
+ *
+ * Usage example:
+ *
+ *   ctx.run("equal", "flat_pod",
+ *           [&](size_t i) { rf::bench::do_not_optimize(rf::is_equal(lhs[i % n], rhs[i % n])); },
+ *           [&](size_t i) { rf::bench::do_not_optimize(baseline_equal(lhs[i % n], rhs[i % n])); });
+ */
+
+/// prevents the optimizer from removing the computation of value
+template <class T>
+inline void do_not_optimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(void*))
+        asm volatile("" : : "r,m"(value) : "memory");
+    else
+        asm volatile("" : : "m"(value) : "memory");
+#else
+    auto volatile sink = reinterpret_cast<char const volatile&>(value);
+    (void)sink;
+#endif
+}
+
+/// forces pending memory writes (e.g. into output buffers) to be considered observable
+inline void clobber_memory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+struct result
+{
+    cc::string name;
+    char const* variant;
+    double ns_per_op;
+    uint64_t iterations;
+    double relative; ///< ns_per_op / ns_per_op of the baseline
+};
+
+struct size_result
+{
+    cc::string name;
+    char const* variant;
+    double bytes_per_op;
+    double relative; ///< bytes_per_op / bytes_per_op of the baseline
+};
+
+class context
+{
+public:
+    /// parses the command line (returns false and prints usage on invalid arguments)
+    bool parse_args(int argc, char** argv);
+
+    /// measures op (reflector) and baseline, both are called as f(size_t i) with increasing i
+    /// results are reported as "operation/subject", e.g. "equal/flat_pod"
+    template <class OpF, class BaselineF>
+    void run(char const* operation, char const* subject, OpF&& op, BaselineF&& baseline)
+    {
+        cc::string name = operation;
+        name += '/';
+        name += subject;
+        if (!is_enabled(name))
+            return;
+
+        auto const op_ns = measure(op);
+        auto const baseline_ns = measure(baseline);
+        add_result(name, "reflector", op_ns, baseline_ns);
+        add_result(name, "baseline", baseline_ns, baseline_ns);
+    }
+
+    /// records the average encoded size per object of op and baseline, and the in-memory size (raw) as reference
+    /// results are reported like timings as "operation/subject"
+    void report_size(char const* operation, char const* subject, double op_bytes, double baseline_bytes, double raw_bytes);
+
+    /// writes all results to stdout
+    void print_results() const;
+
+private:
+    struct timing
+    {
+        double ns_per_op;
+        uint64_t iterations;
+    };
+
+    bool is_enabled(cc::string const& name) const;
+    void add_result(cc::string const& name, char const* variant, timing t, timing baseline);
+    void add_size_result(cc::string const& name, char const* variant, double bytes, double baseline_bytes);
+
+    template <class F>
+    timing measure(F& f) const
+    {
+        using clock = std::chrono::steady_clock;
+
+        // calibrate: grow the batch until a single batch takes a measurable amount of time
+        uint64_t batch = 1;
+        size_t i = 0;
+        while (true)
+        {
+            auto const start = clock::now();
+            for (uint64_t b = 0; b < batch; ++b)
+                f(i++);
+            auto const ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            if (ns * _repetitions >= _min_time_ns || batch >= (uint64_t(1) << 40))
+                break;
+            batch *= 2;
+        }
+
+        // best of all repetitions is the least disturbed measurement
+        auto best = timing{1e300, batch};
+        for (auto r = 0; r < _repetitions; ++r)
+        {
+            auto const start = clock::now();
+            for (uint64_t b = 0; b < batch; ++b)
+                f(i++);
+            auto const ns = std::chrono::duration<double, std::nano>(clock::now() - start).count() / double(batch);
+            if (ns < best.ns_per_op)
+                best.ns_per_op = ns;
+        }
+        return best;
+    }
+
+    double _min_time_ns = 200e6;
+    int _repetitions = 5;
+    bool _json = false;
+    cc::vector<cc::string> _filters;
+    cc::vector<result> _results;
+    cc::vector<size_result> _size_results;
+};
+
+// benchmark groups (one translation unit each)
+void run_compare_benchmarks(context& ctx);
+void run_string_benchmarks(context& ctx);
+void run_enum_benchmarks(context& ctx);
+void run_serialize_benchmarks(context& ctx);
+void run_sort_benchmarks(context& ctx);
+void run_member_benchmarks(context& ctx);
+}
@@ -0,0 +1,155 @@
+#include "bench.hh"
+#include "corpus.hh"
+
+#include <clean-core/span.hh>
+
+#include <reflector/batch.hh>
+#include <reflector/compare.hh>
+#include <reflector/hash.hh>
+#include <reflector/hashed.hh>
+
+using namespace rf::bench;
+
+namespace
+{
+constexpr size_t pool_size = 256; // power of two
+
+template <class T>
+void run_type(context& ctx, char const* type_name)
+{
+    auto const lhs = make_values<T>(pool_size);
+    auto const rhs = make_mostly_equal(lhs);
+    auto const mask = pool_size - 1;
+
+    ctx.run(
+        "equal", type_name, //
+        [&](size_t i) { do_not_optimize(rf::is_equal(lhs[i & mask], rhs[i & mask])); },
+        [&](size_t i) { do_not_optimize(baseline_equal(lhs[i & mask], rhs[i & mask])); });
+
+    ctx.run(
+        "compare", type_name, //
+        [&](size_t i) { do_not_optimize(rf::compare(lhs[i & mask], rhs[i & mask])); },
+        [&](size_t i) { do_not_optimize(baseline_compare(lhs[i & mask], rhs[i & mask])); });
+
+    ctx.run(
+        "hash", type_name, //
+        [&](size_t i) { do_not_optimize(rf::make_hash(lhs[i & mask])); },
+        [&](size_t i) { do_not_optimize(baseline_hash(lhs[i & mask])); });
+}
+
+/// whole ranges as a single value
+template <class T>
+void run_range(context& ctx, char const* name, size_t count)
+{
+    auto const lhs = make_values<T>(count);
+    auto const rhs = lhs;
+
+    ctx.run(
+        "equal", name, //
+        [&](size_t) { do_not_optimize(rf::is_equal(lhs, rhs)); }, [&](size_t) { do_not_optimize(baseline_equal(lhs, rhs)); });
+
+    ctx.run(
+        "compare", name, //
+        [&](size_t) { do_not_optimize(rf::compare(lhs, rhs)); }, [&](size_t) { do_not_optimize(baseline_compare(lhs, rhs)); });
+
+    ctx.run(
+        "hash", name, //
+        [&](size_t) { do_not_optimize(rf::make_hash(lhs)); }, [&](size_t) { do_not_optimize(baseline_hash(lhs)); });
+}
+
+/// batched operations vs. a loop over the single-value operation
+template <class T>
+void run_batch(context& ctx, char const* name, size_t count)
+{
+    auto const lhs = make_values<T>(count);
+    auto const rhs = make_mostly_equal(lhs);
+    cc::vector<uint64_t> hashes;
+    hashes.resize(count);
+    cc::vector<uint64_t> equal_mask;
+    equal_mask.resize(rf::mask_word_count(count));
+
+    ctx.run(
+        "hash_many", name, //
+        [&](size_t)
+        {
+            rf::hash_many(lhs, cc::span<uint64_t>(hashes));
+            clobber_memory();
+        },
+        [&](size_t)
+        {
+            for (size_t i = 0; i < count; ++i)
+                hashes[i] = rf::make_hash(lhs[i]);
+            clobber_memory();
+        });
+
+    ctx.run(
+        "equal_many", name, //
+        [&](size_t)
+        {
+            rf::equal_many(lhs, rhs, cc::span<uint64_t>(equal_mask));
+            clobber_memory();
+        },
+        [&](size_t)
+        {
+            for (auto& w : equal_mask)
+                w = 0;
+            for (size_t i = 0; i < count; ++i)
+                equal_mask[i / 64] |= uint64_t(rf::is_equal(lhs[i], rhs[i])) << (i % 64);
+            clobber_memory();
+        });
+}
+
+/// re-hashing after a small edit: rf::hashed members vs. hashing the plain object
+struct hashed_scene
+{
+    rf::hashed<cc::vector<nested_3>> static_geometry;
+    rf::hashed<cc::vector<flat_pod>> instances;
+    int32_t frame;
+};
+REFL_MAKE_INTROSPECTABLE(hashed_scene, static_geometry, instances, frame);
+
+struct plain_scene
+{
+    cc::vector<nested_3> static_geometry;
+    cc::vector<flat_pod> instances;
+    int32_t frame;
+};
+REFL_MAKE_INTROSPECTABLE(plain_scene, static_geometry, instances, frame);
+
+void run_hashed(context& ctx)
+{
+    auto hashed = hashed_scene{make_values<nested_3>(256), make_values<flat_pod>(64), 0};
+    auto plain = plain_scene{hashed.static_geometry.get(), hashed.instances.get(), 0};
+
+    ctx.run(
+        "rehash_after_edit", "scene", //
+        [&](size_t i)
+        {
+            hashed.instances.write()[i % 64].id = int32_t(i);
+            do_not_optimize(rf::make_hash(hashed));
+        },
+        [&](size_t i)
+        {
+            plain.instances[i % 64].id = int32_t(i);
+            do_not_optimize(rf::make_hash(plain));
+        });
+}
+}
+
+void rf::bench::run_compare_benchmarks(context& ctx)
+{
+    run_type<flat_pod>(ctx, "flat_pod");
+    run_type<flat_ints>(ctx, "flat_ints");
+    run_type<padded>(ctx, "padded");
+    run_type<nested_3>(ctx, "nested_3");
+    run_type<wide>(ctx, "wide");
+    run_type<record>(ctx, "record");
+
+    run_range<int64_t>(ctx, "vector<int64_t>[4096]", 4096);
+    run_range<float>(ctx, "vector<float>[4096]", 4096);
+
+    run_batch<flat_ints>(ctx, "flat_ints[4096]", 4096);
+    run_batch<padded>(ctx, "padded[4096]", 4096);
+
+    run_hashed(ctx);
+}
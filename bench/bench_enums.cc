@@ -0,0 +1,90 @@
+#include "bench.hh"
+#include "corpus.hh"
+
+#include <reflector/enums.hh>
+
+using namespace rf::bench;
+
+namespace
+{
+constexpr size_t pool_size = 1024; // power of two
+
+template <class E>
+void run_enum(context& ctx, char const* enum_name)
+{
+    auto const values = make_values<E>(pool_size);
+    auto const mask = pool_size - 1;
+
+    // names as they would arrive from a file, i.e. not the literals themselves
+    cc::vector<cc::string> names;
+    cc::vector<cc::string> unknown_names;
+    for (auto v : values)
+    {
+        names.push_back(cc::string(rf::enum_to_string(v)));
+        unknown_names.push_back(names.back());
+        unknown_names.back() += '_';
+    }
+
+    ctx.run(
+        "enum_to_string", enum_name, //
+        [&](size_t i) { do_not_optimize(rf::enum_to_string(values[i & mask]).data()); },
+        [&](size_t i) { do_not_optimize(baseline_enum_to_string(values[i & mask])); });
+
+    ctx.run(
+        "enum_from_string", enum_name, //
+        [&](size_t i)
+        {
+            E v = {};
+            do_not_optimize(rf::enum_from_string(cc::string_view(names[i & mask]), v));
+            do_not_optimize(v);
+        },
+        [&](size_t i)
+        {
+            E v = {};
+            do_not_optimize(baseline_enum_from_string(names[i & mask].c_str(), v));
+            do_not_optimize(v);
+        });
+
+    ctx.run(
+        "enum_from_string_unknown", enum_name, //
+        [&](size_t i)
+        {
+            E v = {};
+            do_not_optimize(rf::enum_from_string(cc::string_view(unknown_names[i & mask]), v));
+        },
+        [&](size_t i)
+        {
+            E v = {};
+            do_not_optimize(baseline_enum_from_string(unknown_names[i & mask].c_str(), v));
+        });
+
+    // the X Macro from-string functions vs. a strcmp chain
+    ctx.run(
+        "xlist_from_string", enum_name, //
+        [&](size_t i)
+        {
+            E v = {};
+            do_not_optimize(xlist_from_string(names[i & mask].c_str(), names[i & mask].size(), v));
+            do_not_optimize(v);
+        },
+        [&](size_t i)
+        {
+            E v = {};
+            do_not_optimize(baseline_enum_from_string(names[i & mask].c_str(), v));
+            do_not_optimize(v);
+        });
+
+    auto const fun = [](auto v, int scale) { return int(v.value) * scale + 1; };
+    ctx.run(
+        "enum_invoke", enum_name, //
+        [&](size_t i) { do_not_optimize(rf::enum_invoke(values[i & mask], fun, 3)); },
+        [&](size_t i) { do_not_optimize(baseline_enum_invoke(values[i & mask], [&](auto v) { return fun(v, 3); })); });
+}
+}
+
+void rf::bench::run_enum_benchmarks(context& ctx)
+{
+    run_enum<enum_8>(ctx, "enum_8");
+    run_enum<enum_64>(ctx, "enum_64");
+    run_enum<enum_512>(ctx, "enum_512");
+}
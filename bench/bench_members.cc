@@ -0,0 +1,94 @@
+#include "bench.hh"
+#include "corpus.hh"
+
+#include <reflector/members.hh>
+#include <reflector/visit_member.hh>
+
+using namespace rf::bench;
+
+namespace
+{
+constexpr size_t pool_size = 1024; // power of two
+
+/// reads an arithmetic member as double
+struct member_reader
+{
+    double& out;
+
+    template <class M>
+    void operator()(M const& m, cc::string_view)
+    {
+        if constexpr (std::is_arithmetic_v<M>)
+            out = double(m);
+    }
+};
+
+template <class T>
+void run_members(context& ctx, char const* type_name)
+{
+    auto const values = make_values<T>(pool_size);
+    auto const mask = pool_size - 1;
+    auto const member_count = rf::member_count<T>;
+
+    // random member accesses, names as they would arrive from a file (i.e. not the literals themselves)
+    cc::vector<size_t> indices;
+    cc::vector<cc::string> names;
+    auto r = rng{7};
+    for (size_t i = 0; i < pool_size; ++i)
+    {
+        indices.push_back(size_t(r() % member_count));
+        names.push_back(cc::string(rf::member_infos<T>[indices.back()].name));
+    }
+
+    // the baseline is what visit_member replaces: a full introspect pass that compares every member
+    ctx.run(
+        "visit_member_index", type_name, //
+        [&](size_t i)
+        {
+            double v = 0;
+            do_not_optimize(rf::visit_member(values[i & mask], indices[i & mask], member_reader{v}));
+            do_not_optimize(v);
+        },
+        [&](size_t i)
+        {
+            double v = 0;
+            size_t idx = 0;
+            rf::do_introspect(
+                [&, target = indices[i & mask]](auto& m, cc::string_view name)
+                {
+                    if (idx++ == target)
+                        member_reader{v}(m, name);
+                },
+                const_cast<T&>(values[i & mask]));
+            do_not_optimize(v);
+        });
+
+    ctx.run(
+        "visit_member_name", type_name, //
+        [&](size_t i)
+        {
+            double v = 0;
+            do_not_optimize(rf::visit_member(values[i & mask], cc::string_view(names[i & mask]), member_reader{v}));
+            do_not_optimize(v);
+        },
+        [&](size_t i)
+        {
+            double v = 0;
+            auto const target = cc::string_view(names[i & mask]);
+            rf::do_introspect(
+                [&](auto& m, cc::string_view name)
+                {
+                    if (name == target)
+                        member_reader{v}(m, name);
+                },
+                const_cast<T&>(values[i & mask]));
+            do_not_optimize(v);
+        });
+}
+}
+
+void rf::bench::run_member_benchmarks(context& ctx)
+{
+    run_members<flat_pod>(ctx, "flat_pod");
+    run_members<wide>(ctx, "wide");
+}
@@ -0,0 +1,125 @@
+#include "bench.hh"
+#include "corpus.hh"
+
+#include <reflector/compact.hh>
+#include <reflector/diff.hh>
+#include <reflector/serialize.hh>
+
+using namespace rf::bench;
+
+namespace
+{
+constexpr size_t pool_size = 64; // power of two
+
+template <class T>
+void run_type(context& ctx, char const* type_name)
+{
+    auto const values = make_values<T>(pool_size);
+    auto const mask = pool_size - 1;
+    rf::byte_writer writer;
+
+    ctx.run(
+        "serialize", type_name, //
+        [&](size_t i)
+        {
+            writer.clear();
+            rf::serialize(writer, values[i & mask]);
+            do_not_optimize(writer.data().data());
+        },
+        [&](size_t i)
+        {
+            writer.clear();
+            baseline_serialize(writer, values[i & mask]);
+            do_not_optimize(writer.data().data());
+        });
+
+    // the compact encoding trades encoding time for size, rf::serialize is the reference here
+    ctx.run(
+        "encode_compact", type_name, //
+        [&](size_t i)
+        {
+            writer.clear();
+            rf::encode_compact(writer, values[i & mask]);
+            do_not_optimize(writer.data().data());
+        },
+        [&](size_t i)
+        {
+            writer.clear();
+            rf::serialize(writer, values[i & mask]);
+            do_not_optimize(writer.data().data());
+        });
+
+    // decoding from pre-encoded buffers, again relative to rf::deserialize
+    cc::vector<rf::byte_writer> fixed;
+    cc::vector<rf::byte_writer> compact;
+    fixed.resize(pool_size);
+    compact.resize(pool_size);
+    size_t fixed_bytes = 0;
+    size_t compact_bytes = 0;
+    for (size_t i = 0; i < pool_size; ++i)
+    {
+        rf::serialize(fixed[i], values[i]);
+        rf::encode_compact(compact[i], values[i]);
+        fixed_bytes += fixed[i].data().size();
+        compact_bytes += compact[i].data().size();
+    }
+
+    // encoded sizes: compact vs. rf::serialize, with the in-memory layout as reference
+    ctx.report_size("encoded_size", type_name, double(compact_bytes) / pool_size, double(fixed_bytes) / pool_size, double(sizeof(T)));
+
+    ctx.run(
+        "decode_compact", type_name, //
+        [&](size_t i)
+        {
+            auto reader = rf::byte_reader(compact[i & mask].data());
+            T v = {};
+            do_not_optimize(rf::decode_compact(reader, v));
+            do_not_optimize(v);
+        },
+        [&](size_t i)
+        {
+            auto reader = rf::byte_reader(fixed[i & mask].data());
+            T v = {};
+            do_not_optimize(rf::deserialize(reader, v));
+            do_not_optimize(v);
+        });
+}
+
+/// replicating an object where a single nested member changed: patch vs. full object
+void run_diff(context& ctx)
+{
+    auto const old_values = make_values<nested_3>(pool_size);
+    auto new_values = old_values;
+    auto const mask = pool_size - 1;
+    rf::byte_writer writer;
+
+    ctx.run(
+        "diff", "nested_3", //
+        [&](size_t i)
+        {
+            new_values[i & mask].a.b.c = int32_t(i);
+            writer.clear();
+            rf::diff(writer, old_values[i & mask], new_values[i & mask]);
+            do_not_optimize(writer.data().data());
+        },
+        [&](size_t i)
+        {
+            new_values[i & mask].a.b.c = int32_t(i);
+            writer.clear();
+            rf::serialize(writer, new_values[i & mask]);
+            do_not_optimize(writer.data().data());
+        });
+}
+}
+
+void rf::bench::run_serialize_benchmarks(context& ctx)
+{
+    run_type<flat_pod>(ctx, "flat_pod");
+    run_type<flat_ints>(ctx, "flat_ints");
+    run_type<padded>(ctx, "padded");
+    run_type<nested_3>(ctx, "nested_3");
+    run_type<wide>(ctx, "wide");
+    run_type<record>(ctx, "record");
+
+    run_diff(ctx);
+}
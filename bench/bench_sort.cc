@@ -0,0 +1,64 @@
+#include "bench.hh"
+#include "corpus.hh"
+
+#include <algorithm>
+
+#include <reflector/radix_sort.hh>
+
+using namespace rf::bench;
+
+namespace
+{
+/// every iteration sorts a fresh copy of the input (the copy is part of both variants)
+template <class T, class SortF, class BaselineF>
+void run_sort(context& ctx, char const* name, size_t count, SortF&& sort, BaselineF&& baseline)
+{
+    auto const input = make_values<T>(count);
+    auto values = input;
+
+    ctx.run(
+        "radix_sort", name, //
+        [&](size_t)
+        {
+            values = input;
+            sort(values);
+            do_not_optimize(values.data());
+        },
+        [&](size_t)
+        {
+            values = input;
+            baseline(values);
+            do_not_optimize(values.data());
+        });
+}
+}
+
+void rf::bench::run_sort_benchmarks(context& ctx)
+{
+    run_sort<uint32_t>(
+        ctx, "uint32[65536]", 1 << 16, //
+        [](auto& v) { rf::radix_sort(v); }, [](auto& v) { std::sort(v.begin(), v.end()); });
+
+    run_sort<float>(
+        ctx, "float[65536]", 1 << 16, //
+        [](auto& v) { rf::radix_sort(v); }, [](auto& v) { std::sort(v.begin(), v.end()); });
+
+    // radix sort is stable, so the baseline is as well
+    run_sort<flat_ints>(
+        ctx, "flat_ints[65536]", 1 << 16, //
+        [](auto& v) { rf::radix_sort(v); },
+        [](auto& v) { std::stable_sort(v.begin(), v.end(), [](auto const& a, auto const& b) { return baseline_compare(a, b) < 0; }); });
+
+    run_sort<flat_ints>(
+        ctx, "flat_ints[65536]/by_kind_layer", 1 << 16, //
+        [](auto& v) { rf::radix_sort_by(v, &flat_ints::kind, &flat_ints::layer); },
+        [](auto& v)
+        {
+            std::stable_sort(v.begin(), v.end(),
+                             [](auto const& a, auto const& b) { return a.kind != b.kind ? a.kind < b.kind : a.layer < b.layer; });
+        });
+
+    run_sort<uint64_t>(
+        ctx, "uint64[1048576]/parallel", 1 << 20, //
+        [](auto& v) { rf::radix_sort(v, rf::radix_sort_mode::parallel); }, [](auto& v) { std::sort(v.begin(), v.end()); });
+}
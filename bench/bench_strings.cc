@@ -0,0 +1,70 @@
+#include "bench.hh"
+#include "corpus.hh"
+
+#include <reflector/json.hh>
+#include <reflector/to_string.hh>
+
+using namespace rf::bench;
+
+namespace
+{
+constexpr size_t pool_size = 64; // power of two
+
+template <class T>
+void run_type(context& ctx, char const* type_name)
+{
+    auto const values = make_values<T>(pool_size);
+    auto const mask = pool_size - 1;
+
+    ctx.run(
+        "to_string", type_name, //
+        [&](size_t i) { do_not_optimize(rf::to_string(values[i & mask])); },
+        [&](size_t i)
+        {
+            cc::string s;
+            baseline_to_string(s, values[i & mask]);
+            do_not_optimize(s);
+        });
+
+    // streaming into a reused buffer (no allocations after warmup)
+    cc::string buffer;
+    ctx.run(
+        "write_to", type_name, //
+        [&](size_t i)
+        {
+            buffer.clear();
+            rf::write_to(buffer, values[i & mask]);
+            do_not_optimize(buffer);
+        },
+        [&](size_t i)
+        {
+            buffer.clear();
+            baseline_to_string(buffer, values[i & mask]);
+            do_not_optimize(buffer);
+        });
+
+    ctx.run(
+        "write_json", type_name, //
+        [&](size_t i)
+        {
+            buffer.clear();
+            rf::write_json(buffer, values[i & mask]);
+            do_not_optimize(buffer);
+        },
+        [&](size_t i)
+        {
+            buffer.clear();
+            baseline_json(buffer, values[i & mask]);
+            do_not_optimize(buffer);
+        });
+}
+}
+
+void rf::bench::run_string_benchmarks(context& ctx)
+{
+    run_type<flat_pod>(ctx, "flat_pod");
+    run_type<padded>(ctx, "padded");
+    run_type<nested_3>(ctx, "nested_3");
+    run_type<wide>(ctx, "wide");
+    run_type<record>(ctx, "record");
+}
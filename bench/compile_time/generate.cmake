@@ -0,0 +1,61 @@
+# generates the source of reflector-compile-bench
+#
+# usage: cmake -DOUTPUT=<file.cc> -DTYPE_COUNT=<n> -P generate.cmake
+#
+# every generated type comes with an enum of 16 values and a function that uses all common queries on both
+# even types are tightly packed, odd types have padding (so both branches of the layout checks are covered)
+
+if (NOT OUTPUT OR NOT TYPE_COUNT)
+    message(FATAL_ERROR "OUTPUT and TYPE_COUNT must be set")
+endif()
+
+set(SRC "// generated by bench/compile_time/generate.cmake, do not edit\n\n")
+string(APPEND SRC "#include <cstdint>\n\n")
+string(APPEND SRC "#include <reflector/compare.hh>\n")
+string(APPEND SRC "#include <reflector/enums.hh>\n")
+string(APPEND SRC "#include <reflector/hash.hh>\n")
+string(APPEND SRC "#include <reflector/macros.hh>\n")
+string(APPEND SRC "#include <reflector/members.hh>\n")
+string(APPEND SRC "#include <reflector/to_string.hh>\n\n")
+string(APPEND SRC "namespace gen\n{\n")
+
+math(EXPR LAST "${TYPE_COUNT} - 1")
+foreach (I RANGE ${LAST})
+    math(EXPR IS_ODD "${I} % 2")
+    if (IS_ODD)
+        string(APPEND SRC "struct type_${I}\n{\n    char tag;\n    double value;\n    int16_t count;\n    int64_t stamp;\n    bool alive;\n};\n")
+        string(APPEND SRC "REFL_MAKE_INTROSPECTABLE(type_${I}, tag, value, count, stamp, alive);\n\n")
+    else()
+        string(APPEND SRC "struct type_${I}\n{\n    int64_t stamp;\n    int32_t id;\n    uint32_t flags;\n    uint16_t kind;\n    uint8_t layer;\n    uint8_t mask;\n    float weight;\n};\n")
+        string(APPEND SRC "REFL_MAKE_INTROSPECTABLE(type_${I}, stamp, id, flags, kind, layer, mask, weight);\n\n")
+    endif()
+
+    set(VALUES "")
+    set(INSPECTS "")
+    foreach (V RANGE 15)
+        string(APPEND VALUES "    value_${V},\n")
+        string(APPEND INSPECTS "    inspect(v, enum_${I}::value_${V}, \"value_${V}\");\n")
+    endforeach()
+    string(APPEND SRC "enum class enum_${I}\n{\n${VALUES}};\n")
+    string(APPEND SRC "template <class In>\nconstexpr void introspect_enum(In&& inspect, enum_${I}& v)\n{\n${INSPECTS}}\n\n")
+endforeach()
+
+string(APPEND SRC "}\n\n")
+
+foreach (I RANGE ${LAST})
+    string(APPEND SRC "uint64_t query_${I}(gen::type_${I} const& t, gen::enum_${I} e, cc::string_view name)\n{\n")
+    string(APPEND SRC "    uint64_t r = rf::member_count<gen::type_${I}> + rf::member_offsets<gen::type_${I}>()[1];\n")
+    string(APPEND SRC "    r += rf::make_hash(t) + rf::is_equal(t, t) + rf::is_less(t, t) + rf::to_string(t).size();\n")
+    string(APPEND SRC "    r += rf::enum_value_count<gen::enum_${I}> + rf::enum_names<gen::enum_${I}>[0].size() + uint64_t(rf::enum_values<gen::enum_${I}>[1]);\n")
+    string(APPEND SRC "    r += rf::enum_to_string(e).size() + rf::is_enum_value_valid(e) + uint64_t(rf::enum_from_string<gen::enum_${I}>(name));\n")
+    string(APPEND SRC "    return r;\n}\n\n")
+endforeach()
+
+# only rewrite on change to avoid needless rebuilds
+if (EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" OLD_SRC)
+    if (OLD_SRC STREQUAL SRC)
+        return()
+    endif()
+endif()
+file(WRITE "${OUTPUT}" "${SRC}")
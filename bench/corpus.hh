@@ -0,0 +1,415 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <clean-core/assert.hh>
+#include <clean-core/hash.hh>
+#include <clean-core/string.hh>
+#include <clean-core/to_string.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/macros.hh>
+#include <reflector/serialize.hh>
+
+/**
+ * Benchmark corpus: introspectable types and enums together with their hand-written baselines
+ *
+ * All types are generated from X Macro field lists X(type, name), so the reflector and baseline versions always see the same members
+ * Baselines are what one would write without reflection: explicit member-by-member code
+ */
+
+// =========================================
+// field lists
+
+#define REFL_BENCH_FLAT_POD(X) \
+    X(int32_t, id)             \
+    X(float, x)                \
+    X(float, y)                \
+    X(float, z)                \
+    X(uint32_t, flags)         \
+    X(uint16_t, kind)          \
+    X(uint8_t, layer)          \
+    X(bool, visible)
+
+// integers only, no padding
+#define REFL_BENCH_FLAT_INTS(X) \
+    X(int64_t, stamp)           \
+    X(int32_t, id)              \
+    X(uint32_t, flags)          \
+    X(uint32_t, owner)          \
+    X(uint16_t, kind)           \
+    X(uint8_t, layer)           \
+    X(uint8_t, mask)
+
+// padding holes between members
+#define REFL_BENCH_PADDED(X) \
+    X(char, tag)             \
+    X(double, value)         \
+    X(int16_t, count)        \
+    X(int64_t, stamp)        \
+    X(bool, alive)
+
+#define REFL_BENCH_NESTED_0(X) \
+    X(flat_ints, a)            \
+    X(float, weight)
+#define REFL_BENCH_NESTED_1(X) \
+    X(nested_0, a)             \
+    X(nested_0, b)             \
+    X(int32_t, c)
+#define REFL_BENCH_NESTED_2(X) \
+    X(nested_1, a)             \
+    X(nested_1, b)             \
+    X(double, d)
+#define REFL_BENCH_NESTED_3(X) \
+    X(nested_2, a)             \
+    X(nested_2, b)             \
+    X(int64_t, e)
+
+#define REFL_BENCH_WIDE(X)                                                                                               \
+    X(int32_t, f00) X(float, f01) X(int32_t, f02) X(float, f03) X(int32_t, f04) X(float, f05) X(int32_t, f06) X(float, f07) \
+    X(int32_t, f08) X(float, f09) X(int32_t, f10) X(float, f11) X(int32_t, f12) X(float, f13) X(int32_t, f14) X(float, f15) \
+    X(int32_t, f16) X(float, f17) X(int32_t, f18) X(float, f19) X(int32_t, f20) X(float, f21) X(int32_t, f22) X(float, f23) \
+    X(int32_t, f24) X(float, f25) X(int32_t, f26) X(float, f27) X(int32_t, f28) X(float, f29) X(int32_t, f30) X(float, f31)
+
+// dynamically sized members
+#define REFL_BENCH_RECORD(X)       \
+    X(cc::string, name)            \
+    X(cc::vector<int32_t>, values) \
+    X(flat_pod, pod)
+
+// =========================================
+// enum value lists (8, 64, and 512 values)
+
+#define REFL_BENCH_X8(X, P) X(P##0) X(P##1) X(P##2) X(P##3) X(P##4) X(P##5) X(P##6) X(P##7)
+#define REFL_BENCH_X64(X, P)                                                                                               \
+    REFL_BENCH_X8(X, P##0) REFL_BENCH_X8(X, P##1) REFL_BENCH_X8(X, P##2) REFL_BENCH_X8(X, P##3) REFL_BENCH_X8(X, P##4) \
+    REFL_BENCH_X8(X, P##5) REFL_BENCH_X8(X, P##6) REFL_BENCH_X8(X, P##7)
+#define REFL_BENCH_X512(X, P)                                                                                                   \
+    REFL_BENCH_X64(X, P##0) REFL_BENCH_X64(X, P##1) REFL_BENCH_X64(X, P##2) REFL_BENCH_X64(X, P##3) REFL_BENCH_X64(X, P##4) \
+    REFL_BENCH_X64(X, P##5) REFL_BENCH_X64(X, P##6) REFL_BENCH_X64(X, P##7)
+
+#define REFL_BENCH_ENUM_8(X) REFL_BENCH_X8(X, value_)
+#define REFL_BENCH_ENUM_64(X) REFL_BENCH_X64(X, value_)
+#define REFL_BENCH_ENUM_512(X) REFL_BENCH_X512(X, value_)
+
+// =========================================
+// generators
+
+#define REFL_BENCH_X_DECLARE(T, name) T name;
+#define REFL_BENCH_X_INSPECT(T, name) inspect(v.name, #name);
+#define REFL_BENCH_X_EQUAL(T, name) &&baseline_equal(a.name, b.name)
+#define REFL_BENCH_X_COMPARE(T, name)                       \
+    if (auto const c = baseline_compare(a.name, b.name); c) \
+        return c;
+#define REFL_BENCH_X_HASH(T, name) h = cc::hash_combine(h, baseline_hash(v.name));
+#define REFL_BENCH_X_TO_STRING(T, name) \
+    s += sep;                           \
+    s += #name ": ";                    \
+    baseline_to_string(s, v.name);      \
+    sep = ", ";
+#define REFL_BENCH_X_JSON(T, name) \
+    s += sep;                     \
+    s += "\"" #name "\":";         \
+    baseline_json(s, v.name);     \
+    sep = ",";
+#define REFL_BENCH_X_SERIALIZE(T, name) baseline_serialize(w, v.name);
+#define REFL_BENCH_X_RANDOMIZE(T, name) randomize(v.name, rng);
+
+#define REFL_BENCH_DEFINE_TYPE(Type, Fields)                                                                \
+    struct Type                                                                                             \
+    {                                                                                                       \
+        Fields(REFL_BENCH_X_DECLARE)                                                                        \
+    };                                                                                                      \
+    REFL_INTROSPECT(Type) { Fields(REFL_BENCH_X_INSPECT) }                                                  \
+    inline bool baseline_equal(Type const& a, Type const& b) { return true Fields(REFL_BENCH_X_EQUAL); }    \
+    inline int baseline_compare(Type const& a, Type const& b)                                               \
+    {                                                                                                       \
+        Fields(REFL_BENCH_X_COMPARE) return 0;                                                              \
+    }                                                                                                       \
+    inline uint64_t baseline_hash(Type const& v)                                                            \
+    {                                                                                                       \
+        uint64_t h = 0;                                                                                     \
+        Fields(REFL_BENCH_X_HASH) return h;                                                                 \
+    }                                                                                                       \
+    inline void baseline_to_string(cc::string& s, Type const& v)                                            \
+    {                                                                                                       \
+        char const* sep = "{ ";                                                                             \
+        Fields(REFL_BENCH_X_TO_STRING) s += " }";                                                           \
+    }                                                                                                       \
+    inline void baseline_json(cc::string& s, Type const& v)                                                 \
+    {                                                                                                       \
+        char const* sep = "{";                                                                              \
+        Fields(REFL_BENCH_X_JSON) s += "}";                                                                 \
+    }                                                                                                       \
+    inline void baseline_serialize(rf::byte_writer& w, Type const& v) { Fields(REFL_BENCH_X_SERIALIZE) }   \
+    template <class Rng>                                                                                    \
+    void randomize(Type& v, Rng& rng)                                                                       \
+    {                                                                                                       \
+        Fields(REFL_BENCH_X_RANDOMIZE)                                                                      \
+    }                                                                                                       \
+    CC_FORCE_SEMICOLON
+
+#define REFL_BENCH_X_ENUM_INSPECT(Val) inspect(v, rf_xlist_enum::Val, #Val);
+#define REFL_BENCH_X_ENUM_VALUE(Val) rf_xlist_enum::Val,
+#define REFL_BENCH_X_INVOKE_CASE(Val) \
+    case rf_xlist_enum::Val:          \
+        return f(std::integral_constant<rf_xlist_enum, rf_xlist_enum::Val>());
+
+#define REFL_BENCH_DEFINE_ENUM(Type, List)                                  \
+    REFL_DECLARE_ENUM_CLASS(Type, List);                                    \
+    REFL_DECLARE_TOSTRING(baseline_enum_to_string, Type, List)              \
+    REFL_DECLARE_FROMSTRING(xlist_from_string, Type, List)                  \
+    inline bool baseline_enum_from_string(char const* str, Type& out_value) \
+    {                                                                       \
+        using rf_xlist_enum = Type;                                         \
+        List(REFL_X_FROMSTRING_IF) return false;                            \
+    }                                                                       \
+    template <class In>                                                     \
+    constexpr void introspect_enum(In&& inspect, Type& v)                   \
+    {                                                                       \
+        using rf_xlist_enum = Type;                                         \
+        List(REFL_BENCH_X_ENUM_INSPECT)                                     \
+    }                                                                       \
+    template <class F>                                                      \
+    decltype(auto) baseline_enum_invoke(Type v, F&& f)                      \
+    {                                                                       \
+        using rf_xlist_enum = Type;                                         \
+        switch (v)                                                          \
+        {                                                                   \
+            List(REFL_BENCH_X_INVOKE_CASE)                                  \
+        }                                                                   \
+        CC_UNREACHABLE("unknown enum value");                               \
+    }                                                                       \
+    template <class Rng>                                                    \
+    void randomize(Type& v, Rng& rng)                                       \
+    {                                                                       \
+        using rf_xlist_enum = Type;                                         \
+        constexpr Type values[] = {List(REFL_BENCH_X_ENUM_VALUE)};          \
+        v = values[rng() % (sizeof(values) / sizeof(values[0]))];           \
+    }                                                                       \
+    CC_FORCE_SEMICOLON
+
+namespace rf::bench
+{
+/// xorshift64*, deterministic across platforms
+struct rng
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    uint64_t operator()()
+    {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+};
+
+// =========================================
+// baselines for leaf types
+
+template <class T>
+bool baseline_equal(T const& a, T const& b)
+{
+    return a == b;
+}
+template <class T>
+int baseline_compare(T const& a, T const& b)
+{
+    return a < b ? -1 : b < a ? 1 : 0;
+}
+template <class T>
+uint64_t baseline_hash(T const& v)
+{
+    return cc::hash<T>{}(v);
+}
+template <class T>
+void baseline_to_string(cc::string& s, T const& v)
+{
+    s += cc::to_string(v);
+}
+inline int baseline_compare(cc::string const& a, cc::string const& b)
+{
+    auto const n = a.size() < b.size() ? a.size() : b.size();
+    if (auto const c = std::memcmp(a.data(), b.data(), n); c)
+        return c < 0 ? -1 : 1;
+    return a.size() < b.size() ? -1 : b.size() < a.size() ? 1 : 0;
+}
+inline void baseline_to_string(cc::string& s, cc::string const& v)
+{
+    s += '"';
+    s += v;
+    s += '"';
+}
+template <class T>
+void baseline_json(cc::string& s, T const& v)
+{
+    if constexpr (std::is_same_v<T, char>)
+    {
+        // generated chars are printable and need no escaping
+        s += '"';
+        s += v;
+        s += '"';
+    }
+    else
+        s += cc::to_string(v);
+}
+inline void baseline_json(cc::string& s, cc::string const& v)
+{
+    // generated strings need no escaping
+    s += '"';
+    s += v;
+    s += '"';
+}
+template <class T>
+void baseline_serialize(rf::byte_writer& w, T const& v)
+{
+    static_assert(std::is_arithmetic_v<T>, "missing baseline");
+    w.write(&v, sizeof(T));
+}
+inline void baseline_serialize(rf::byte_writer& w, cc::string const& v)
+{
+    auto const size = uint64_t(v.size());
+    w.write(&size, sizeof(size));
+    w.write(v.data(), v.size());
+}
+
+template <class T, class Rng>
+void randomize(T& v, Rng& rng)
+{
+    static_assert(std::is_arithmetic_v<T>, "missing generator");
+    if constexpr (std::is_same_v<T, bool>)
+        v = rng() & 1;
+    else if constexpr (std::is_same_v<T, char>)
+        v = char('a' + rng() % 26);
+    else if constexpr (std::is_floating_point_v<T>)
+        v = T(rng() % 100000) / T(100);
+    else
+        v = T(rng());
+}
+template <class Rng>
+void randomize(cc::string& v, Rng& rng)
+{
+    v.clear();
+    auto const size = 4 + rng() % 24;
+    for (uint64_t i = 0; i < size; ++i)
+        v += char('a' + rng() % 26);
+}
+
+// ranges, element-wise
+template <class T>
+bool baseline_equal(cc::vector<T> const& a, cc::vector<T> const& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (!baseline_equal(a[i], b[i]))
+            return false;
+    return true;
+}
+template <class T>
+int baseline_compare(cc::vector<T> const& a, cc::vector<T> const& b)
+{
+    auto const n = a.size() < b.size() ? a.size() : b.size();
+    for (size_t i = 0; i < n; ++i)
+        if (auto const c = baseline_compare(a[i], b[i]); c)
+            return c;
+    return baseline_compare(a.size(), b.size());
+}
+template <class T>
+uint64_t baseline_hash(cc::vector<T> const& v)
+{
+    uint64_t h = 0;
+    for (auto const& e : v)
+        h = cc::hash_combine(h, baseline_hash(e));
+    return h;
+}
+template <class T>
+void baseline_to_string(cc::string& s, cc::vector<T> const& v)
+{
+    s += '[';
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        if (i > 0)
+            s += ", ";
+        baseline_to_string(s, v[i]);
+    }
+    s += ']';
+}
+template <class T>
+void baseline_json(cc::string& s, cc::vector<T> const& v)
+{
+    s += '[';
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+        if (i > 0)
+            s += ',';
+        baseline_json(s, v[i]);
+    }
+    s += ']';
+}
+template <class T>
+void baseline_serialize(rf::byte_writer& w, cc::vector<T> const& v)
+{
+    auto const size = uint64_t(v.size());
+    w.write(&size, sizeof(size));
+    for (auto const& e : v)
+        baseline_serialize(w, e);
+}
+template <class T, class Rng>
+void randomize(cc::vector<T>& v, Rng& rng)
+{
+    v.resize(8 + rng() % 56);
+    for (auto& e : v)
+        randomize(e, rng);
+}
+
+// =========================================
+// types
+
+REFL_BENCH_DEFINE_TYPE(flat_pod, REFL_BENCH_FLAT_POD);
+REFL_BENCH_DEFINE_TYPE(flat_ints, REFL_BENCH_FLAT_INTS);
+REFL_BENCH_DEFINE_TYPE(padded, REFL_BENCH_PADDED);
+REFL_BENCH_DEFINE_TYPE(nested_0, REFL_BENCH_NESTED_0);
+REFL_BENCH_DEFINE_TYPE(nested_1, REFL_BENCH_NESTED_1);
+REFL_BENCH_DEFINE_TYPE(nested_2, REFL_BENCH_NESTED_2);
+REFL_BENCH_DEFINE_TYPE(nested_3, REFL_BENCH_NESTED_3);
+REFL_BENCH_DEFINE_TYPE(wide, REFL_BENCH_WIDE);
+REFL_BENCH_DEFINE_TYPE(record, REFL_BENCH_RECORD);
+
+// =========================================
+// enums
+
+REFL_BENCH_DEFINE_ENUM(enum_8, REFL_BENCH_ENUM_8);
+REFL_BENCH_DEFINE_ENUM(enum_64, REFL_BENCH_ENUM_64);
+REFL_BENCH_DEFINE_ENUM(enum_512, REFL_BENCH_ENUM_512);
+
+// =========================================
+// inputs
+
+/// count random values
+template <class T>
+cc::vector<T> make_values(size_t count, uint64_t seed = 1)
+{
+    auto r = rng{0x9E3779B97F4A7C15ULL ^ (seed * 0xBF58476D1CE4E5B9ULL)};
+    cc::vector<T> values;
+    values.resize(count);
+    for (auto& v : values)
+        randomize(v, r);
+    return values;
+}
+
+/// copies of values where every other element is replaced by a new random value
+/// (half of the comparisons have to traverse the whole object)
+template <class T>
+cc::vector<T> make_mostly_equal(cc::vector<T> const& values)
+{
+    auto copies = values;
+    auto r = rng{};
+    for (size_t i = 1; i < copies.size(); i += 2)
+        randomize(copies[i], r);
+    return copies;
+}
+}
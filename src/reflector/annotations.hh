@@ -0,0 +1,58 @@
+#pragma once
+
+#include <type_traits>
+
+namespace rf
+{
+/**
+ * Member annotations: compile-time tags passed after the member name
+ *
+ * Declaration example:
+ *
+ *    template <class In>
+ *    constexpr void introspect(In&& inspect, mesh& v)
+ *    {
+ *        inspect(v.vertices, "vertices");
+ *        inspect(v.bounds, "bounds", rf::transient); // derived from vertices
+ *        inspect(v.debug_name, "debug_name", rf::no_hash, rf::no_compare);
+ *    }
+ *
+ * Annotated members are skipped by the respective operations (decided at compile time):
+ *   rf::no_hash      - rf::hash, rf::make_hash, rf::hash_many
+ *   rf::no_compare   - rf::is_equal, rf::compare, rf::is_less (and the other comparisons), rf::radix_sort, rf::diff
+ *   rf::no_serialize - rf::serialize, rf::deserialize, rf::to_json, rf::read_json, rf::encode_compact, rf::decode_compact, rf::diff
+ *   rf::transient    - all of the above and rf::to_string (i.e. cached or derived state that is not part of the value)
+ *
+ * NOTE: types with a user-defined operator==, operator<, or cc::hash use those instead (and thus ignore annotations)
+ *       deserialization leaves skipped members untouched
+ *       structural operations (rf::member_infos, rf::soa_vector, rf::visit_member, the registry, ...) still see all members
+ */
+struct no_hash_t
+{
+};
+struct no_compare_t
+{
+};
+struct no_serialize_t
+{
+};
+struct transient_t
+{
+};
+
+inline constexpr no_hash_t no_hash = {};
+inline constexpr no_compare_t no_compare = {};
+inline constexpr no_serialize_t no_serialize = {};
+inline constexpr transient_t transient = {};
+
+namespace detail
+{
+template <class Tag, class... Args>
+constexpr bool has_annotation = (std::is_same_v<std::decay_t<Args>, Tag> || ...);
+
+/// true iff an operation that honors Tag skips a member with the annotations Args
+/// (transient members are skipped by all operations)
+template <class Tag, class... Args>
+constexpr bool is_skipped = has_annotation<Tag, Args...> || has_annotation<transient_t, Args...>;
+}
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+#include <clean-core/assert.hh>
+#include <clean-core/has_operator.hh>
+#include <clean-core/hash.hh>
+#include <clean-core/span.hh>
+
+#include <reflector/compare.hh>
+#include <reflector/detail/hashify.hh>
+#include <reflector/detail/range_traits.hh>
+
+namespace rf
+{
+/**
+ * Batched versions of rf::hash and rf::is_equal for contiguous ranges of objects
+ *
+ * The results are identical to calling the single-object versions per element, but:
+ *   - the type dispatch and the cached member run plans are resolved once per batch instead of once per object
+ *   - bytewise types (see detail::is_bytewise_comparable) are processed with fixed-size loads
+ *     that the compiler can unroll and vectorize, first-mismatch search scans the raw bytes of the whole range
+ *
+ * Equality results are written as a bitmask: bit (i % 64) of mask[i / 64] is set iff lhs[i] == rhs[i]
+ * (unused bits in the last word are zero)
+ *
+ * Usage example:
+ *
+ *   cc::vector<uint64_t> hashes;
+ *   hashes.resize(records.size());
+ *   rf::hash_many(records, hashes);
+ *
+ *   cc::vector<uint64_t> mask;
+ *   mask.resize(rf::mask_word_count(records.size()));
+ *   rf::equal_many(records, cached_records, mask);
+ *
+ *   auto first_changed = rf::compare_many(records, cached_records);
+ */
+
+/// number of uint64_t words needed for a bitmask of n elements
+constexpr size_t mask_word_count(size_t n) { return (n + 63) / 64; }
+
+/// returns true iff bit i of the mask is set
+constexpr bool mask_test(cc::span<uint64_t const> mask, size_t i) { return (mask[i / 64] >> (i % 64)) & 1; }
+
+namespace detail
+{
+/// equality of the object representations of two objects of a fixed size
+template <size_t Size>
+bool bytes_equal(void const* lhs, void const* rhs)
+{
+    if constexpr (Size == 1 || Size == 2 || Size == 4 || Size == 8)
+    {
+        using word_t = std::conditional_t<Size == 1, uint8_t, std::conditional_t<Size == 2, uint16_t, std::conditional_t<Size == 4, uint32_t, uint64_t>>>;
+        word_t a, b;
+        std::memcpy(&a, lhs, Size);
+        std::memcpy(&b, rhs, Size);
+        return a == b;
+    }
+    else
+        return std::memcmp(lhs, rhs, Size) == 0;
+}
+
+/// returns the index of the first differing byte or size if the ranges are equal
+inline size_t first_mismatching_byte(std::byte const* lhs, std::byte const* rhs, size_t size)
+{
+    size_t i = 0;
+
+    // 32 bytes per iteration: locate the block first, then the byte
+    for (; i + 32 <= size; i += 32)
+    {
+        uint64_t a[4], b[4];
+        std::memcpy(a, lhs + i, 32);
+        std::memcpy(b, rhs + i, 32);
+        if (((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3])) != 0)
+            break;
+    }
+
+    for (; i < size; ++i)
+        if (lhs[i] != rhs[i])
+            return i;
+    return size;
+}
+
+template <class T>
+void impl_hash_many(T const* values, size_t count, uint64_t* out)
+{
+    if constexpr (cc::can_hash<T>)
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = cc::hash<T>{}(values[i]);
+    }
+    else if constexpr (is_bytewise_hashable<T>)
+    {
+        // fixed size: the hash of each object is fully unrolled
+        for (size_t i = 0; i < count; ++i)
+            out[i] = hash_bytes(values + i, sizeof(T));
+    }
+    else if constexpr (rf::is_introspectable<T>)
+    {
+        if (count == 0)
+            return;
+
+        // the run plan is looked up once for the whole batch
+        auto const& plan = cached_member_runs<hash_fn, hash_policy, T>();
+        if (plan.is_beneficial())
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = run_hash(plan, values + i);
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = impl_make_hash(values[i]);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = impl_make_hash(values[i]);
+    }
+}
+
+template <class EqualF>
+void fill_equal_mask(size_t count, uint64_t* mask, EqualF&& is_equal_at)
+{
+    for (size_t w = 0; w * 64 < count; ++w)
+    {
+        auto const base = w * 64;
+        auto const cnt = count - base < 64 ? count - base : size_t(64);
+
+        uint64_t word = 0;
+        for (size_t j = 0; j < cnt; ++j)
+            word |= uint64_t(is_equal_at(base + j)) << j;
+        mask[w] = word;
+    }
+}
+
+template <class T>
+void impl_equal_many(T const* lhs, T const* rhs, size_t count, uint64_t* mask)
+{
+    if constexpr (!cc::has_operator_equal<T, T> && is_bytewise_comparable<T>)
+    {
+        fill_equal_mask(count, mask, [&](size_t i) { return bytes_equal<sizeof(T)>(lhs + i, rhs + i); });
+    }
+    else if constexpr (!cc::has_operator_equal<T, T> && rf::is_introspectable<T>)
+    {
+        if (count == 0)
+            return;
+
+        // the run plan is looked up once for the whole batch
+        auto const& plan = cached_member_runs<equal_fn, equal_policy, T>();
+        if (plan.is_beneficial())
+            fill_equal_mask(count, mask, [&](size_t i) { return run_equal(plan, lhs + i, rhs + i); });
+        else
+            fill_equal_mask(count, mask, [&](size_t i) { return rf::is_equal(lhs[i], rhs[i]); });
+    }
+    else
+    {
+        fill_equal_mask(count, mask, [&](size_t i) { return rf::is_equal(lhs[i], rhs[i]); });
+    }
+}
+
+template <class T>
+size_t impl_compare_many(T const* lhs, T const* rhs, size_t count)
+{
+    if constexpr (!cc::has_operator_equal<T, T> && is_bytewise_comparable<T>)
+    {
+        auto const byte = first_mismatching_byte(reinterpret_cast<std::byte const*>(lhs), reinterpret_cast<std::byte const*>(rhs), count * sizeof(T));
+        return byte / sizeof(T);
+    }
+    else if constexpr (!cc::has_operator_equal<T, T> && rf::is_introspectable<T>)
+    {
+        if (count == 0)
+            return 0;
+
+        auto const& plan = cached_member_runs<equal_fn, equal_policy, T>();
+        auto const use_plan = plan.is_beneficial();
+        for (size_t i = 0; i < count; ++i)
+            if (use_plan ? !run_equal(plan, lhs + i, rhs + i) : !rf::is_equal(lhs[i], rhs[i]))
+                return i;
+        return count;
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+            if (!rf::is_equal(lhs[i], rhs[i]))
+                return i;
+        return count;
+    }
+}
+}
+
+/// out[i] = rf::hash{}(values[i]) for all elements of the contiguous range values
+/// NOTE: out must have at least as many elements as values
+template <class Range>
+void hash_many(Range const& values, cc::span<uint64_t> out)
+{
+    static_assert(detail::is_contiguous_range_t<Range>::value, "values must be a contiguous range");
+    using T = detail::range_element_t<Range>;
+
+    auto const count = size_t(std::size(values));
+    CC_ASSERT(out.size() >= count && "output too small");
+    detail::impl_hash_many<T>(std::data(values), count, out.data());
+}
+
+/// writes the bitmask of rf::is_equal(lhs[i], rhs[i]) for all elements of the contiguous ranges lhs and rhs (see above)
+/// NOTE: lhs and rhs must have the same size, mask must have at least rf::mask_word_count(size) elements
+template <class RangeA, class RangeB>
+void equal_many(RangeA const& lhs, RangeB const& rhs, cc::span<uint64_t> mask)
+{
+    static_assert(detail::is_contiguous_range_t<RangeA>::value && detail::is_contiguous_range_t<RangeB>::value, "lhs and rhs must be contiguous ranges");
+    using T = detail::range_element_t<RangeA>;
+    static_assert(std::is_same_v<T, detail::range_element_t<RangeB>>, "lhs and rhs must have the same element type");
+
+    auto const count = size_t(std::size(lhs));
+    CC_ASSERT(size_t(std::size(rhs)) == count && "size mismatch");
+    CC_ASSERT(mask.size() >= mask_word_count(count) && "mask too small");
+    detail::impl_equal_many<T>(std::data(lhs), std::data(rhs), count, mask.data());
+}
+
+/// returns the index of the first i with !rf::is_equal(lhs[i], rhs[i]) or the size if all elements are equal
+/// NOTE: lhs and rhs must be contiguous ranges of the same size
+template <class RangeA, class RangeB>
+[[nodiscard]] size_t compare_many(RangeA const& lhs, RangeB const& rhs)
+{
+    static_assert(detail::is_contiguous_range_t<RangeA>::value && detail::is_contiguous_range_t<RangeB>::value, "lhs and rhs must be contiguous ranges");
+    using T = detail::range_element_t<RangeA>;
+    static_assert(std::is_same_v<T, detail::range_element_t<RangeB>>, "lhs and rhs must have the same element type");
+
+    auto const count = size_t(std::size(lhs));
+    CC_ASSERT(size_t(std::size(rhs)) == count && "size mismatch");
+    return detail::impl_compare_many<T>(std::data(lhs), std::data(rhs), count);
+}
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <clean-core/always_false.hh>
+#include <clean-core/assert.hh>
+#include <clean-core/is_range.hh>
+
+#include <reflector/detail/range_traits.hh>
+#include <reflector/detail/serialize.hh>
+#include <reflector/enums.hh>
+#include <reflector/introspect.hh>
+
+namespace rf
+{
+/**
+ * Introspection-based, size-optimized binary encoding (e.g. for network replication)
+ *
+ * Format:
+ *   - bool: packed bits, each group of 8 bools shares one byte (placed where the first bool of the group is encountered)
+ *   - 1 byte integers: raw byte
+ *   - unsigned integers: LEB128 varint
+ *   - signed integers: zigzag + LEB128 varint
+ *   - introspectable enums: varint of their index in rf::enum_values (value must be registered)
+ *   - other enums: their underlying integer
+ *   - floating point: raw bytes
+ *   - introspectable types: their introspected members in order
+ *   - ranges: varint element count followed by the elements (ranges of 1 byte integers, e.g. strings, are copied in bulk)
+ *
+ * Writers provide `void write(void const* data, size_t size)`, `size_t size() const`,
+ *                 and `void write_at(size_t offset, void const* data, size_t size)` (e.g. rf::byte_writer)
+ * Readers provide `bool read(void* data, size_t size)` (e.g. rf::byte_reader)
+ *
+ * NOTE: the bool packing state is per encode/decode call, so values must be decoded with the same call granularity
+ *       floating point values use the native endianness
+ *
+ * Usage example:
+ *
+ *   rf::byte_writer writer;
+ *   rf::encode_compact(writer, my_value);
+ *
+ *   auto reader = rf::byte_reader(writer.data());
+ *   if (!rf::decode_compact(reader, my_value))
+ *       ... // error handling
+ */
+
+namespace detail
+{
+template <class T>
+constexpr bool is_compact_raw_integer = std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) == 1;
+
+inline uint64_t zigzag_encode(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+inline int64_t zigzag_decode(uint64_t v) { return int64_t(v >> 1) ^ -int64_t(v & 1); }
+
+template <class Writer>
+struct compact_encoder
+{
+    Writer& writer;
+
+    size_t bool_byte_pos = 0;
+    int bool_bits_used = 8; // 8 means "no open bool byte"
+    uint8_t bool_byte = 0;
+
+    void write_bool(bool v)
+    {
+        if (bool_bits_used == 8)
+        {
+            bool_byte_pos = writer.size();
+            bool_byte = 0;
+            bool_bits_used = 0;
+            writer.write(&bool_byte, 1);
+        }
+        bool_byte |= uint8_t(v) << bool_bits_used++;
+        writer.write_at(bool_byte_pos, &bool_byte, 1);
+    }
+
+    void write_varint(uint64_t v)
+    {
+        uint8_t buffer[10];
+        size_t size = 0;
+        while (v >= 0x80)
+        {
+            buffer[size++] = uint8_t(v) | 0x80;
+            v >>= 7;
+        }
+        buffer[size++] = uint8_t(v);
+        writer.write(buffer, size);
+    }
+
+    template <class T>
+    void encode(T const& v)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            write_bool(v);
+        else if constexpr (is_compact_raw_integer<T> || std::is_floating_point_v<T>)
+            writer.write(&v, sizeof(T));
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            write_varint(zigzag_encode(int64_t(v)));
+        else if constexpr (std::is_integral_v<T>)
+            write_varint(uint64_t(v));
+        else if constexpr (std::is_enum_v<T>)
+        {
+            if constexpr (rf::is_enum_introspectable<T>)
+            {
+                auto const idx = detail::enum_index_of(v);
+                CC_ASSERT(idx != detail::enum_invalid_index && "only registered enum values can be encoded");
+                write_varint(idx);
+            }
+            else
+                encode(std::underlying_type_t<T>(v));
+        }
+        else if constexpr (rf::is_introspectable<T>)
+        {
+            rf::do_introspect(
+                [this](auto const& m, auto&&... annotations)
+                {
+                    if constexpr (!is_skipped<no_serialize_t, decltype(annotations)...>)
+                        this->encode(m);
+                },
+                const_cast<T&>(v)); // promise we will not change v
+        }
+        else if constexpr (cc::is_any_range<T>)
+        {
+            using element_t = range_element_t<T>;
+
+            auto const size = range_size(v);
+            write_varint(size);
+
+            if constexpr (is_contiguous_range_t<T>::value && is_compact_raw_integer<element_t>)
+                writer.write(std::data(v), size);
+            else
+                for (auto const& e : v)
+                    encode(e);
+        }
+        else
+            static_assert(cc::always_false<T>, "type cannot be encoded (must be arithmetic, enum, introspectable, or a range)");
+    }
+};
+
+template <class Reader>
+struct compact_decoder
+{
+    Reader& reader;
+
+    int bool_bits_used = 8; // 8 means "no open bool byte"
+    uint8_t bool_byte = 0;
+
+    bool read_bool(bool& v)
+    {
+        if (bool_bits_used == 8)
+        {
+            if (!reader.read(&bool_byte, 1))
+                return false;
+            bool_bits_used = 0;
+        }
+        v = (bool_byte >> bool_bits_used++) & 1;
+        return true;
+    }
+
+    bool read_varint(uint64_t& v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t b;
+            if (!reader.read(&b, 1))
+                return false;
+            if (shift == 63 && b > 1)
+                return false; // the 10th byte only holds bit 63, anything else overflows
+            v |= uint64_t(b & 0x7F) << shift;
+            if (b < 0x80)
+                return true;
+        }
+        return false; // overlong encoding
+    }
+
+    template <class T>
+    bool read_integer(T& v)
+    {
+        uint64_t u;
+        if (!read_varint(u))
+            return false;
+
+        if constexpr (std::is_signed_v<T>)
+        {
+            auto const s = zigzag_decode(u);
+            v = T(s);
+            return int64_t(v) == s;
+        }
+        else
+        {
+            v = T(u);
+            return uint64_t(v) == u;
+        }
+    }
+
+    template <class T>
+    bool decode(T& v)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return read_bool(v);
+        else if constexpr (is_compact_raw_integer<T> || std::is_floating_point_v<T>)
+            return reader.read(&v, sizeof(T));
+        else if constexpr (std::is_integral_v<T>)
+            return read_integer(v);
+        else if constexpr (std::is_enum_v<T>)
+        {
+            if constexpr (rf::is_enum_introspectable<T>)
+            {
+                uint64_t idx;
+                if (!read_varint(idx) || idx >= rf::enum_value_count<T>)
+                    return false;
+                v = rf::enum_values<T>[idx];
+                return true;
+            }
+            else
+            {
+                std::underlying_type_t<T> u;
+                if (!decode(u))
+                    return false;
+                v = T(u);
+                return true;
+            }
+        }
+        else if constexpr (rf::is_introspectable<T>)
+        {
+            auto ok = true;
+            rf::do_introspect(
+                [&](auto& m, auto&&... annotations)
+                {
+                    if constexpr (!is_skipped<no_serialize_t, decltype(annotations)...>)
+                    {
+                        if (ok)
+                            ok = this->decode(m);
+                    }
+                },
+                v);
+            return ok;
+        }
+        else if constexpr (cc::is_any_range<T>)
+        {
+            using element_t = range_element_t<T>;
+
+            uint64_t size;
+            if (!read_varint(size))
+                return false;
+
+            if constexpr (has_resize_t<T>::value)
+            {
+                // reject corrupted sizes before allocating (every element takes at least one bit)
+                if constexpr (has_reader_remaining_t<Reader>::value)
+                    if (size / 8 > reader.remaining())
+                        return false;
+
+                v.resize(size_t(size));
+            }
+            else if (size != range_size(v))
+                return false; // fixed-size ranges must match
+
+            if constexpr (is_contiguous_range_t<T>::value && is_compact_raw_integer<element_t>)
+                return reader.read(std::data(v), size_t(size));
+            else
+            {
+                for (auto& e : v)
+                    if (!decode(e))
+                        return false;
+                return true;
+            }
+        }
+        else
+        {
+            static_assert(cc::always_false<T>, "type cannot be decoded (must be arithmetic, enum, introspectable, or a range)");
+            return false;
+        }
+    }
+};
+}
+
+/// writes value in the compact encoding to the writer
+template <class Writer, class T>
+void encode_compact(Writer& writer, T const& value)
+{
+    auto encoder = detail::compact_encoder<Writer>{writer};
+    encoder.encode(value);
+}
+
+/// reads value in the compact encoding from the reader
+/// returns false if the reader ran out of data or the data is invalid
+/// (value might be partially overwritten in that case)
+template <class Reader, class T>
+[[nodiscard]] bool decode_compact(Reader& reader, T& value)
+{
+    auto decoder = detail::compact_decoder<Reader>{reader};
+    return decoder.decode(value);
+}
+}
@@ -1,17 +1,47 @@
 #pragma once
 
 #include <cstddef>
+#include <cstring>
+#include <iterator>
 #include <type_traits>
 
 #include <clean-core/assert.hh>
 #include <clean-core/bit_cast.hh>
 #include <clean-core/has_operator.hh>
+#include <clean-core/is_range.hh>
 #include <clean-core/move.hh>
 
+#include <reflector/detail/layout.hh>
 #include <reflector/introspect.hh>
 
+#if defined(__cpp_impl_three_way_comparison) && __cpp_impl_three_way_comparison >= 201907L && __has_include(<compare>)
+#include <compare>
+#define REFL_IMPL_HAS_THREE_WAY_COMPARISON 1
+#else
+#define REFL_IMPL_HAS_THREE_WAY_COMPARISON 0
+#endif
+
 namespace rf
 {
+/// result of a three-way comparison
+/// NOTE: unordered values (e.g. NaN) compare as equal, consistent with rf::is_less
+enum class ordering : signed char
+{
+    less = -1,
+    equal = 0,
+    greater = 1
+};
+
+/// three-way comparison in a single traversal
+///
+/// in this order, the following are tested:
+/// * lhs <=> rhs (C++20)
+/// * lhs < rhs (at most two calls)
+/// * memberwise lexicographic comparison via introspect (stops at the first unequal member)
+/// * lexicographic comparison of ranges
+template <class T>
+[[nodiscard]] ordering compare(T const& lhs, T const& rhs) noexcept;
+
 /// returns lhs == rhs if defined, otherwise performs a memberwise comparison
 template <class T>
 [[nodiscard]] bool is_equal(T const& lhs, T const& rhs) noexcept;
@@ -49,6 +79,14 @@ template <class T>
 }
 
 // type operator versions
+struct compare_three_way
+{
+    template <class T>
+    [[nodiscard]] ordering operator()(T const& lhs, T const& rhs) const noexcept
+    {
+        return rf::compare(lhs, rhs);
+    }
+};
 struct equal
 {
     template <class T>
@@ -103,10 +141,13 @@ namespace detail
 template <class FunctorT>
 struct MemberwiseComparator
 {
-    MemberwiseComparator(FunctorT comp_op, size_t outer_size) : outer_size(outer_size), comp_op(comp_op) {}
+    MemberwiseComparator(FunctorT comp_op, void const* lhs, void const* rhs, size_t outer_size)
+      : rhs_raw(static_cast<std::byte const*>(rhs)), lhs_delta(static_cast<std::byte const*>(lhs) - rhs_raw), outer_size(outer_size), comp_op(comp_op)
+    {
+    }
 
-    std::byte const* lhs_raw;
     std::byte const* rhs_raw;
+    std::ptrdiff_t lhs_delta; ///< lhs members are at the same offset as their rhs counterparts
     size_t outer_size;
     FunctorT comp_op;
     bool condition_true = true;
@@ -115,16 +156,122 @@ struct MemberwiseComparator
     void operator()(T const& rhs_member, Args&&...) noexcept
     {
         static_assert(sizeof(T) > 0, "No incomplete members allowed");
-        if (condition_true)
+        if constexpr (is_skipped<no_compare_t, Args...>)
+            return;
+        else if (condition_true)
         {
-            size_t const member_offset = reinterpret_cast<std::byte const*>(&rhs_member) - rhs_raw;
-            CC_ASSERT(member_offset < outer_size);
-            T const& lhs_member = *reinterpret_cast<T const*>(lhs_raw + member_offset);
+            auto const rhs_member_raw = reinterpret_cast<std::byte const*>(&rhs_member);
+            CC_ASSERT(size_t(rhs_member_raw - rhs_raw) < outer_size);
+            T const& lhs_member = *reinterpret_cast<T const*>(rhs_member_raw + lhs_delta);
             static_assert(std::is_same_v<T const&, decltype(lhs_member)>);
             condition_true = comp_op(lhs_member, rhs_member);
         }
     }
 };
+
+/// three-way counterpart of MemberwiseComparator: stops at the first member that is not equal
+struct MemberwiseThreeWayComparator
+{
+    MemberwiseThreeWayComparator(void const* lhs, void const* rhs, size_t outer_size)
+      : rhs_raw(static_cast<std::byte const*>(rhs)), lhs_delta(static_cast<std::byte const*>(lhs) - rhs_raw), outer_size(outer_size)
+    {
+    }
+
+    std::byte const* rhs_raw;
+    std::ptrdiff_t lhs_delta; ///< lhs members are at the same offset as their rhs counterparts
+    size_t outer_size;
+    ordering result = ordering::equal;
+
+    template <class T, class... Args>
+    void operator()(T const& rhs_member, Args&&...) noexcept
+    {
+        static_assert(sizeof(T) > 0, "No incomplete members allowed");
+        if constexpr (is_skipped<no_compare_t, Args...>)
+            return;
+        else if (result == ordering::equal)
+        {
+            auto const rhs_member_raw = reinterpret_cast<std::byte const*>(&rhs_member);
+            CC_ASSERT(size_t(rhs_member_raw - rhs_raw) < outer_size);
+            T const& lhs_member = *reinterpret_cast<T const*>(rhs_member_raw + lhs_delta);
+            result = rf::compare(lhs_member, rhs_member);
+        }
+    }
+};
+
+#if REFL_IMPL_HAS_THREE_WAY_COMPARISON
+template <class T, class = void>
+struct has_three_way_t : std::false_type
+{
+};
+template <class T>
+struct has_three_way_t<T, std::void_t<decltype(std::declval<T const&>() <=> std::declval<T const&>())>> : std::true_type
+{
+};
+#endif
+
+template <class T>
+constexpr bool has_three_way_comparison =
+#if REFL_IMPL_HAS_THREE_WAY_COMPARISON
+    has_three_way_t<T>::value;
+#else
+    false;
+#endif
+
+template <class T>
+struct is_bytewise_comparable_t;
+
+/// true iff rf::is_equal(a, b) is equivalent to memcmp(&a, &b, sizeof(T)) == 0
+/// NOTE: floating point types are excluded (0.0 == -0.0 and NaN != NaN)
+///       types with a user-defined operator== are excluded (we must respect its semantics)
+template <class T>
+constexpr bool compute_is_bytewise_comparable()
+{
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)
+        return true;
+    else if constexpr (std::is_array_v<T>)
+        return is_bytewise_comparable_t<std::remove_extent_t<T>>::value;
+    else if constexpr (std::is_class_v<T> && !cc::has_operator_equal<T, T> && is_layout_analyzable<T> && std::has_unique_object_representations_v<T>)
+        return members_tile<T, is_bytewise_comparable_t, no_compare_t>();
+    else
+        return false;
+}
+
+template <class T>
+struct is_bytewise_comparable_t : std::bool_constant<compute_is_bytewise_comparable<T>()>
+{
+};
+
+template <class T>
+constexpr bool is_bytewise_comparable = is_bytewise_comparable_t<T>::value;
+
+using equal_fn = bool (*)(void const*, void const*);
+
+struct equal_policy
+{
+    using annotation = no_compare_t;
+
+    template <class M>
+    static constexpr bool is_bytewise = is_bytewise_comparable<M>;
+
+    template <class M>
+    static bool apply(void const* lhs, void const* rhs)
+    {
+        return rf::is_equal(*static_cast<M const*>(lhs), *static_cast<M const*>(rhs));
+    }
+};
+
+inline bool run_equal(member_runs<equal_fn> const& plan, void const* lhs, void const* rhs)
+{
+    auto const lhs_raw = static_cast<std::byte const*>(lhs);
+    auto const rhs_raw = static_cast<std::byte const*>(rhs);
+    for (auto const& r : plan.runs)
+    {
+        auto const equal = r.fn ? r.fn(lhs_raw + r.offset, rhs_raw + r.offset) : std::memcmp(lhs_raw + r.offset, rhs_raw + r.offset, r.size) == 0;
+        if (!equal)
+            return false;
+    }
+    return true;
+}
 }
 
 template <class T>
@@ -135,34 +282,85 @@ template <class T>
     {
         return lhs == rhs;
     }
+    else if constexpr (detail::is_bytewise_comparable<T>)
+    {
+        // members exactly tile T without padding: single bulk compare
+        return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+    }
     else
     {
-        auto const comp_op = [](auto const& lhs, auto const& rhs) { return rf::is_equal(lhs, rhs); };
-        auto comparator = detail::MemberwiseComparator(comp_op, sizeof(T));
-        comparator.lhs_raw = reinterpret_cast<std::byte const*>(&lhs);
-        comparator.rhs_raw = reinterpret_cast<std::byte const*>(&rhs);
+        // one memcmp per run of adjacent bytewise members (stopping at the first unequal run)
+        auto const& plan = detail::cached_member_runs<detail::equal_fn, detail::equal_policy, T>();
+        if (plan.is_beneficial())
+            return detail::run_equal(plan, &lhs, &rhs);
+
+        // NOTE: a named functor (instead of a lambda) shares the comparator instantiations between all types with the same member types
+        auto comparator = detail::MemberwiseComparator<rf::equal>(rf::equal{}, &lhs, &rhs, sizeof(T));
         do_introspect<T>(comparator, const_cast<T&>(rhs));
         return comparator.condition_true;
     }
 }
 
 
+template <class T>
+[[nodiscard]] ordering compare(T const& lhs, T const& rhs) noexcept
+{
+    static_assert(sizeof(T) > 0, "No incomplete types allowed");
+    // NOTE: built-in operators on C arrays compare addresses, so arrays are compared as ranges
+    if constexpr (detail::has_three_way_comparison<T> && !std::is_array_v<T>)
+    {
+#if REFL_IMPL_HAS_THREE_WAY_COMPARISON
+        auto const c = lhs <=> rhs;
+        return c < 0 ? ordering::less : c > 0 ? ordering::greater : ordering::equal;
+#endif
+    }
+    else if constexpr (cc::has_operator_less<T, T> && !std::is_array_v<T>)
+    {
+        if (lhs < rhs)
+            return ordering::less;
+        return rhs < lhs ? ordering::greater : ordering::equal;
+    }
+    else if constexpr (rf::is_introspectable<T>)
+    {
+        auto comparator = detail::MemberwiseThreeWayComparator(&lhs, &rhs, sizeof(T));
+        do_introspect<T>(comparator, const_cast<T&>(rhs));
+        return comparator.result;
+    }
+    else
+    {
+        static_assert(cc::is_any_range<T>, "type is not comparable (needs operator<, introspect, or must be a range)");
+
+        auto lhs_it = std::begin(lhs);
+        auto rhs_it = std::begin(rhs);
+        auto const lhs_end = std::end(lhs);
+        auto const rhs_end = std::end(rhs);
+        for (; lhs_it != lhs_end && rhs_it != rhs_end; ++lhs_it, ++rhs_it)
+        {
+            auto const c = rf::compare(*lhs_it, *rhs_it);
+            if (c != ordering::equal)
+                return c;
+        }
+
+        if (lhs_it != lhs_end)
+            return ordering::greater;
+        if (rhs_it != rhs_end)
+            return ordering::less;
+        return ordering::equal;
+    }
+}
+
 template <class T>
 [[nodiscard]] bool is_less(T const& lhs, T const& rhs) noexcept
 {
     static_assert(sizeof(T) > 0, "No incomplete types allowed");
-    if constexpr (cc::has_operator_less<T, T>)
+    if constexpr (cc::has_operator_less<T, T> && !std::is_array_v<T>)
     {
         return lhs < rhs;
     }
     else
     {
-        auto const comp_op = [](auto const& lhs, auto const& rhs) { return rf::is_less(lhs, rhs); };
-        auto comparator = detail::MemberwiseComparator(comp_op, sizeof(T));
-        comparator.lhs_raw = reinterpret_cast<std::byte const*>(&lhs);
-        comparator.rhs_raw = reinterpret_cast<std::byte const*>(&rhs);
-        do_introspect<T>(comparator, const_cast<T&>(rhs));
-        return comparator.condition_true;
+        // lexicographic: a single traversal that stops at the first unequal member
+        return rf::compare(lhs, rhs) == ordering::less;
     }
 }
 }
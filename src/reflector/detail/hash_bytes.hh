@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+namespace rf::detail
+{
+// high-throughput hashing of raw byte spans
+// based on wyhash (final version 4, public domain, https://github.com/wangyi-fudan/wyhash)
+// NOTE: results depend on the endianness of the platform and are not meant to be persisted
+
+inline void hash_mum(uint64_t& a, uint64_t& b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = a;
+    r *= b;
+    a = uint64_t(r);
+    b = uint64_t(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    a = _umul128(a, b, &b);
+#else
+    uint64_t const ha = a >> 32, hb = b >> 32, la = uint32_t(a), lb = uint32_t(b);
+    uint64_t const rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t const lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+    hash_mum(a, b);
+    return a ^ b;
+}
+
+inline uint64_t hash_read8(std::byte const* p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t hash_read4(std::byte const* p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint64_t hash_read3(std::byte const* p, size_t k)
+{
+    return (uint64_t(p[0]) << 16) | (uint64_t(p[k >> 1]) << 8) | uint64_t(p[k - 1]);
+}
+
+/// hashes size bytes starting at data
+inline uint64_t hash_bytes(void const* data, size_t size, uint64_t seed = 0)
+{
+    constexpr uint64_t s0 = 0xa0761d6478bd642full;
+    constexpr uint64_t s1 = 0xe7037ed1a0b428dbull;
+    constexpr uint64_t s2 = 0x8ebc6af09c88c6e3ull;
+    constexpr uint64_t s3 = 0x589965cc75374cc3ull;
+
+    auto p = static_cast<std::byte const*>(data);
+    seed ^= hash_mix(seed ^ s0, s1);
+
+    uint64_t a, b;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            auto const d = (size >> 3) << 2;
+            a = (hash_read4(p) << 32) | hash_read4(p + d);
+            b = (hash_read4(p + size - 4) << 32) | hash_read4(p + size - 4 - d);
+        }
+        else if (size > 0)
+        {
+            a = hash_read3(p, size);
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        auto i = size;
+        if (i > 48)
+        {
+            // three independent lanes to hide multiplication latency
+            auto see1 = seed, see2 = seed;
+            do
+            {
+                seed = hash_mix(hash_read8(p) ^ s1, hash_read8(p + 8) ^ seed);
+                see1 = hash_mix(hash_read8(p + 16) ^ s2, hash_read8(p + 24) ^ see1);
+                see2 = hash_mix(hash_read8(p + 32) ^ s3, hash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = hash_mix(hash_read8(p) ^ s1, hash_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = hash_read8(p + i - 16);
+        b = hash_read8(p + i - 8);
+    }
+
+    a ^= s1;
+    b ^= seed;
+    hash_mum(a, b);
+    return hash_mix(a ^ s0 ^ size, b ^ s1);
+}
+}
@@ -1,11 +1,29 @@
 #pragma once
 
+#include <iterator>
+#include <type_traits>
+
 #include <clean-core/hash.hh>
+#include <clean-core/is_range.hh>
 
+#include <reflector/detail/hash_bytes.hh>
+#include <reflector/detail/layout.hh>
+#include <reflector/detail/range_traits.hh>
+#include <reflector/fwd.hh>
 #include <reflector/introspect.hh>
 
 namespace rf::detail
 {
+/// std::is_constant_evaluated for C++17 (supported as builtin by GCC 9+, Clang 9+, and MSVC 19.25+)
+constexpr bool is_constant_evaluated() noexcept
+{
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#else
+    return __builtin_is_constant_evaluated();
+#endif
+}
+
 template <class T>
 constexpr uint64_t impl_make_hash(T const& v) noexcept;
 
@@ -16,31 +34,136 @@ struct hash_inspector
     template <class T, class... Args>
     constexpr void operator()(T const& v, Args&&...) noexcept
     {
-        h = cc::hash_combine(h, impl_make_hash(v));
+        if constexpr (!is_skipped<no_hash_t, Args...>)
+            h = cc::hash_combine(h, impl_make_hash(v));
     }
 };
 
+template <class T>
+struct is_hashed_t : std::false_type
+{
+};
+template <class T>
+struct is_hashed_t<rf::hashed<T>> : std::true_type
+{
+};
+
 template <class T, class = void>
 struct can_hash_t : std::false_type
 {
 };
 template <class T>
-struct can_hash_t<T, std::enable_if_t<cc::can_hash<T> || rf::is_introspectable<T>>> : std::true_type
+struct can_hash_t<T, std::enable_if_t<!is_hashed_t<T>::value && (cc::can_hash<T> || rf::is_introspectable<T>)>> : std::true_type
+{
+};
+template <class T>
+struct can_hash_t<T, std::enable_if_t<!is_hashed_t<T>::value && !cc::can_hash<T> && !rf::is_introspectable<T> && cc::is_any_range<T>>>
+  : can_hash_t<range_element_t<T>>
+{
+};
+template <class T>
+struct can_hash_t<rf::hashed<T>> : can_hash_t<T>
+{
+};
+
+template <class T>
+struct is_bytewise_hashable_t;
+
+/// true iff hashing the object representation of T is equivalent to hashing all its introspected members
+/// NOTE: floating point types are excluded (0.0 and -0.0 must have the same hash)
+///       types with a custom cc::hash are excluded (we must respect its semantics)
+template <class T>
+constexpr bool compute_is_bytewise_hashable()
+{
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>)
+        return true;
+    else if constexpr (std::is_array_v<T>)
+        return is_bytewise_hashable_t<std::remove_extent_t<T>>::value;
+    else if constexpr (std::is_class_v<T> && !cc::can_hash<T> && is_layout_analyzable<T> && std::has_unique_object_representations_v<T>)
+        return members_tile<T, is_bytewise_hashable_t, no_hash_t>();
+    else
+        return false;
+}
+
+template <class T>
+struct is_bytewise_hashable_t : std::bool_constant<compute_is_bytewise_hashable<T>()>
+{
+};
+
+template <class T>
+constexpr bool is_bytewise_hashable = is_bytewise_hashable_t<T>::value;
+
+using hash_fn = uint64_t (*)(void const*);
+
+struct hash_policy
 {
+    using annotation = no_hash_t;
+
+    template <class M>
+    static constexpr bool is_bytewise = is_bytewise_hashable<M>;
+
+    template <class M>
+    static uint64_t apply(void const* v)
+    {
+        return impl_make_hash(*static_cast<M const*>(v));
+    }
 };
 
+inline uint64_t run_hash(member_runs<hash_fn> const& plan, void const* v)
+{
+    auto const raw = static_cast<std::byte const*>(v);
+    auto h = cc::hash_combine();
+    for (auto const& r : plan.runs)
+        h = cc::hash_combine(h, r.fn ? r.fn(raw + r.offset) : hash_bytes(raw + r.offset, r.size));
+    return h;
+}
+
+/// NOTE: the bytewise and member run fast paths only exist at runtime (they hash the object representation)
+///       in constant expressions, everything is hashed memberwise
 template <class T>
 constexpr uint64_t impl_make_hash(T const& v) noexcept
 {
-    if constexpr (cc::can_hash<T>)
+    if constexpr (is_hashed_t<T>::value)
+    {
+        // memoized, equal to the hash of the wrapped value
+        return v.hash();
+    }
+    else if constexpr (cc::can_hash<T>)
         return cc::hash<T>{}(v);
-    else
+    else if constexpr (rf::is_introspectable<T>)
     {
-        static_assert(rf::is_introspectable<T>, "must be introspectable");
+        if (!is_constant_evaluated())
+        {
+            // members exactly tile T without padding: single bulk hash
+            if constexpr (is_bytewise_hashable<T>)
+                return hash_bytes(&v, sizeof(T));
+
+            // one hash_bytes call per run of adjacent bytewise members, the other members are hashed individually
+            auto const& plan = cached_member_runs<hash_fn, hash_policy, T>();
+            if (plan.is_beneficial())
+                return run_hash(plan, &v);
+        }
 
         hash_inspector i;
         rf::do_introspect(i, const_cast<T&>(v)); // promise we will not change v
         return i.h;
     }
+    else
+    {
+        static_assert(cc::is_any_range<T>, "must be introspectable or a range");
+
+        using element_t = range_element_t<T>;
+        if constexpr (is_contiguous_range_t<T>::value && is_bytewise_hashable<element_t>)
+        {
+            // single pass over the whole buffer
+            if (!is_constant_evaluated())
+                return hash_bytes(std::data(v), std::size(v) * sizeof(element_t));
+        }
+
+        auto h = cc::hash_combine();
+        for (auto const& e : v)
+            h = cc::hash_combine(h, impl_make_hash(e));
+        return h;
+    }
 }
 }
@@ -0,0 +1,677 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <clean-core/always_false.hh>
+#include <clean-core/array.hh>
+#include <clean-core/is_range.hh>
+#include <clean-core/string_view.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/detail/range_traits.hh>
+#include <reflector/detail/string_table.hh>
+#include <reflector/enums.hh>
+#include <reflector/introspect.hh>
+#include <reflector/members.hh>
+#include <reflector/sink.hh>
+
+namespace rf::detail
+{
+/// cursor over the JSON text
+/// NOTE: the text is never copied or modified, string values without escapes are referenced in place
+struct json_reader
+{
+    char const* cur;
+    char const* end;
+
+    /// nesting limit when skipping unknown values (protects the stack against malicious input)
+    static constexpr int max_skip_depth = 512;
+
+    void skip_ws()
+    {
+        while (cur != end && (*cur == ' ' || *cur == '\n' || *cur == '\r' || *cur == '\t'))
+            ++cur;
+    }
+
+    /// skips whitespace and returns the next char (or 0 at the end)
+    char peek()
+    {
+        skip_ws();
+        return cur != end ? *cur : '\0';
+    }
+
+    /// skips whitespace and consumes c if it is the next char
+    bool consume(char c)
+    {
+        if (peek() != c)
+            return false;
+        ++cur;
+        return true;
+    }
+
+    bool consume_literal(cc::string_view lit)
+    {
+        skip_ws();
+        if (size_t(end - cur) < lit.size())
+            return false;
+        for (size_t i = 0; i < lit.size(); ++i)
+            if (cur[i] != lit[i])
+                return false;
+        cur += lit.size();
+        return true;
+    }
+
+    /// reads a string token and returns its raw (still escaped) content
+    bool read_raw_string(cc::string_view& raw, bool& has_escapes)
+    {
+        if (!consume('"'))
+            return false;
+
+        has_escapes = false;
+        auto const start = cur;
+        while (cur != end)
+        {
+            auto const c = *cur;
+            if (c == '"')
+            {
+                raw = cc::string_view(start, size_t(cur - start));
+                ++cur;
+                return true;
+            }
+
+            if (c == '\\')
+            {
+                has_escapes = true;
+                if (++cur == end)
+                    return false;
+            }
+            else if ((unsigned char)c < 0x20)
+                return false; // control characters must be escaped
+
+            ++cur;
+        }
+        return false;
+    }
+
+    /// reads the characters of a number token (validated later by from_chars)
+    cc::string_view read_number_token()
+    {
+        skip_ws();
+        auto const start = cur;
+        while (cur != end && ((*cur >= '0' && *cur <= '9') || *cur == '-' || *cur == '+' || *cur == '.' || *cur == 'e' || *cur == 'E'))
+            ++cur;
+        return cc::string_view(start, size_t(cur - start));
+    }
+
+    /// skips an arbitrary value without allocating
+    bool skip_value(int depth = 0)
+    {
+        if (depth > max_skip_depth)
+            return false;
+
+        switch (peek())
+        {
+        case '"':
+        {
+            cc::string_view raw;
+            bool has_escapes;
+            return read_raw_string(raw, has_escapes);
+        }
+        case '{':
+            ++cur;
+            if (consume('}'))
+                return true;
+            do
+            {
+                cc::string_view raw;
+                bool has_escapes;
+                if (!read_raw_string(raw, has_escapes) || !consume(':') || !skip_value(depth + 1))
+                    return false;
+            } while (consume(','));
+            return consume('}');
+        case '[':
+            ++cur;
+            if (consume(']'))
+                return true;
+            do
+            {
+                if (!skip_value(depth + 1))
+                    return false;
+            } while (consume(','));
+            return consume(']');
+        case 't':
+            return consume_literal("true");
+        case 'f':
+            return consume_literal("false");
+        case 'n':
+            return consume_literal("null");
+        default:
+            return !read_number_token().empty();
+        }
+    }
+};
+
+constexpr int json_hex_digit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+inline bool json_read_hex4(char const* p, char const* end, uint32_t& v)
+{
+    if (end - p < 4)
+        return false;
+    v = 0;
+    for (auto i = 0; i < 4; ++i)
+    {
+        auto const d = json_hex_digit(p[i]);
+        if (d < 0)
+            return false;
+        v = (v << 4) | uint32_t(d);
+    }
+    return true;
+}
+
+template <class Sink>
+void json_append_utf8(Sink& sink, uint32_t cp)
+{
+    char buffer[4];
+    size_t size;
+    if (cp < 0x80)
+    {
+        buffer[0] = char(cp);
+        size = 1;
+    }
+    else if (cp < 0x800)
+    {
+        buffer[0] = char(0xC0 | (cp >> 6));
+        buffer[1] = char(0x80 | (cp & 0x3F));
+        size = 2;
+    }
+    else if (cp < 0x10000)
+    {
+        buffer[0] = char(0xE0 | (cp >> 12));
+        buffer[1] = char(0x80 | ((cp >> 6) & 0x3F));
+        buffer[2] = char(0x80 | (cp & 0x3F));
+        size = 3;
+    }
+    else
+    {
+        buffer[0] = char(0xF0 | (cp >> 18));
+        buffer[1] = char(0x80 | ((cp >> 12) & 0x3F));
+        buffer[2] = char(0x80 | ((cp >> 6) & 0x3F));
+        buffer[3] = char(0x80 | (cp & 0x3F));
+        size = 4;
+    }
+    sink_append(sink, cc::string_view(buffer, size));
+}
+
+/// appends the unescaped content of a raw JSON string to the sink
+/// NOTE: runs of characters without escapes are appended in bulk
+template <class Sink>
+bool json_unescape(Sink& sink, cc::string_view raw)
+{
+    auto p = raw.data();
+    auto const end = p + raw.size();
+
+    auto run_start = p;
+    while (p != end)
+    {
+        if (*p != '\\')
+        {
+            ++p;
+            continue;
+        }
+
+        if (p > run_start)
+            sink_append(sink, cc::string_view(run_start, size_t(p - run_start)));
+
+        ++p; // backslash (read_raw_string guarantees a following char)
+        switch (*p++)
+        {
+        case '"':
+            sink_append(sink, '"');
+            break;
+        case '\\':
+            sink_append(sink, '\\');
+            break;
+        case '/':
+            sink_append(sink, '/');
+            break;
+        case 'b':
+            sink_append(sink, '\b');
+            break;
+        case 'f':
+            sink_append(sink, '\f');
+            break;
+        case 'n':
+            sink_append(sink, '\n');
+            break;
+        case 'r':
+            sink_append(sink, '\r');
+            break;
+        case 't':
+            sink_append(sink, '\t');
+            break;
+        case 'u':
+        {
+            uint32_t cp;
+            if (!json_read_hex4(p, end, cp))
+                return false;
+            p += 4;
+
+            if (cp >= 0xD800 && cp < 0xDC00) // high surrogate, must be followed by a low one
+            {
+                uint32_t low;
+                if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !json_read_hex4(p + 2, end, low) || low < 0xDC00 || low >= 0xE000)
+                    return false;
+                p += 6;
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            }
+            else if (cp >= 0xDC00 && cp < 0xE000)
+                return false; // unpaired low surrogate
+
+            json_append_utf8(sink, cp);
+            break;
+        }
+        default:
+            return false;
+        }
+
+        run_start = p;
+    }
+
+    if (p > run_start)
+        sink_append(sink, cc::string_view(run_start, size_t(p - run_start)));
+    return true;
+}
+
+template <class T>
+constexpr bool is_json_string_target = std::is_assignable_v<T&, cc::string_view> && !std::is_arithmetic_v<T> && !std::is_enum_v<T>;
+
+template <class T, class = void>
+struct has_emplace_back_t : std::false_type
+{
+};
+template <class T>
+struct has_emplace_back_t<T, std::void_t<decltype(std::declval<T&>().emplace_back())>> : std::true_type
+{
+};
+
+template <class T>
+struct can_read_json_t;
+
+template <class T>
+constexpr bool compute_can_read_json()
+{
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T> || is_json_string_target<T> || rf::is_introspectable<T>)
+        return true;
+    else if constexpr (cc::is_any_range<T>)
+        return (has_resize_t<T>::value || has_range_size_t<T>::value) && can_read_json_t<range_element_t<T>>::value;
+    else
+        return false;
+}
+
+template <class T>
+struct can_read_json_t : std::bool_constant<compute_can_read_json<T>()>
+{
+};
+
+template <class T>
+bool impl_read_json(json_reader& r, T& v);
+
+using json_member_read_fn = bool (*)(json_reader&, void*);
+
+template <class M>
+bool json_read_member(json_reader& r, void* m)
+{
+    return impl_read_json(r, *static_cast<M*>(m));
+}
+
+/// compile-time read functions of the members of T (in introspect order), used with rf::detail::member_name_table
+/// NOTE: skipped members have no read function, i.e. their keys are treated as unknown
+struct JsonReadFnBuilder
+{
+    json_member_read_fn* read_fns;
+
+    template <class M, class... Args>
+    constexpr void operator()(M&, cc::string_view, Args&&...)
+    {
+        if constexpr (!is_skipped<no_serialize_t, Args...>)
+            *read_fns = &json_read_member<M>;
+        ++read_fns;
+    }
+};
+
+template <class T>
+constexpr auto make_json_read_fns()
+{
+    cc::array<json_member_read_fn, rf::member_count<T>> read_fns = {};
+    T t = {};
+    rf::do_introspect(JsonReadFnBuilder{read_fns.data()}, t);
+    return read_fns;
+}
+
+template <class T>
+inline constexpr auto json_read_fns = make_json_read_fns<T>();
+
+/// per-type lookup structure from member names to member offsets and read functions
+/// for types without member_name_table (e.g. types with cc::string members)
+/// NOTE: member offsets are the same for all objects of a type, so the table is built once and cached
+///       member names must outlive the table (which is always the case for string literals)
+struct json_member_table
+{
+    cc::vector<cc::string_view> names;
+    cc::vector<size_t> offsets; ///< from rf::member_offsets
+    cc::vector<json_member_read_fn> read_fns;
+    cc::vector<string_table_entry> entries;
+    size_t capacity = 0;
+    bool is_valid = true; ///< false if some introspected member is not a subobject
+
+    /// returns the index of the member or -1 if not found
+    int find(cc::string_view name) const { return string_table_find<true>(entries, capacity, names, name); }
+};
+
+struct JsonMemberTableBuilder
+{
+    json_member_table& table;
+    member_offset_table const& offsets;
+    size_t idx = 0;
+
+    template <class M, class... Args>
+    void operator()(M&, cc::string_view name, Args&&...)
+    {
+        // skipped members are not in the table, i.e. their keys are treated as unknown
+        if constexpr (!is_skipped<no_serialize_t, Args...>)
+        {
+            table.names.push_back(name);
+            table.offsets.push_back(offsets[idx]);
+            table.read_fns.push_back(&json_read_member<M>);
+        }
+        ++idx;
+    }
+};
+
+/// returns the cached member table of T
+template <class T>
+json_member_table const& cached_json_member_table()
+{
+    static auto const table = []
+    {
+        json_member_table t;
+        auto const& offsets = rf::member_offsets<T>();
+        t.is_valid = offsets.is_valid;
+
+        T obj = {};
+        rf::do_introspect(JsonMemberTableBuilder{t, offsets}, obj);
+
+        t.capacity = string_table_capacity(t.names.size());
+        t.entries.resize(t.capacity);
+        for (size_t i = 0; i < t.names.size(); ++i)
+            string_table_insert<true>(t.entries, t.capacity, t.names, uint32_t(i));
+        return t;
+    }();
+    return table;
+}
+
+/// fallback for types without member table (or introspect functions that list non-subobjects): linear search by name
+/// unknown keys are skipped
+template <class T>
+bool json_read_member_linear(json_reader& r, T& v, cc::string_view key)
+{
+    auto found = false;
+    auto ok = true;
+    rf::do_introspect(
+        [&](auto& m, cc::string_view name, auto&&... annotations)
+        {
+            if constexpr (!is_skipped<no_serialize_t, decltype(annotations)...>)
+            {
+                if (!found && string_equals<true>(name, key))
+                {
+                    found = true;
+                    ok = impl_read_json(r, m);
+                }
+            }
+        },
+        v);
+    return found ? ok : r.skip_value();
+}
+
+/// reads an object key (unescaped into buffer if necessary)
+/// keys that do not fit into the buffer are reported as empty view with ok == true (i.e. treated as unknown)
+template <size_t N>
+bool json_read_key(json_reader& r, char (&buffer)[N], cc::string_view& key)
+{
+    cc::string_view raw;
+    bool has_escapes;
+    if (!r.read_raw_string(raw, has_escapes) || !r.consume(':'))
+        return false;
+
+    if (!has_escapes)
+    {
+        key = raw;
+        return true;
+    }
+
+    auto sink = rf::buffer_sink(buffer);
+    if (!json_unescape(sink, raw))
+        return false;
+    key = sink.is_truncated() ? cc::string_view() : sink.written();
+    return true;
+}
+
+template <class T>
+bool json_read_number(json_reader& r, T& v)
+{
+    auto const token = r.read_number_token();
+    if (token.empty())
+        return false;
+
+    auto const token_end = token.data() + token.size();
+    auto const res = std::from_chars(token.data(), token_end, v);
+    return res.ec == std::errc() && res.ptr == token_end;
+}
+
+/// reads the members of a non-empty object (after the opening brace) and the closing brace
+/// read_member(key) reads or skips the value of a single member
+template <class ReadMemberF>
+bool json_read_object_members(json_reader& r, ReadMemberF&& read_member)
+{
+    do
+    {
+        char buffer[256];
+        cc::string_view key;
+        if (!json_read_key(r, buffer, key) || !read_member(key))
+            return false;
+    } while (r.consume(','));
+
+    return r.consume('}');
+}
+
+template <class T>
+bool impl_read_json(json_reader& r, T& v)
+{
+    if constexpr (std::is_same_v<T, bool>)
+    {
+        if (r.consume_literal("true"))
+            v = true;
+        else if (r.consume_literal("false"))
+            v = false;
+        else
+            return false;
+        return true;
+    }
+    else if constexpr (std::is_same_v<T, char>)
+    {
+        cc::string_view raw;
+        bool has_escapes;
+        if (!r.read_raw_string(raw, has_escapes))
+            return false;
+
+        char buffer[1];
+        auto sink = rf::buffer_sink(buffer);
+        if (!json_unescape(sink, raw) || sink.is_truncated() || sink.size() != 1)
+            return false;
+        v = buffer[0];
+        return true;
+    }
+    else if constexpr (std::is_integral_v<T>)
+        return json_read_number(r, v);
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        // rf::write_json writes inf and nan as null
+        if (r.peek() == 'n')
+        {
+            if (!r.consume_literal("null"))
+                return false;
+            v = std::numeric_limits<T>::quiet_NaN();
+            return true;
+        }
+        return json_read_number(r, v);
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        if (r.peek() != '"')
+        {
+            std::underlying_type_t<T> u;
+            if (!json_read_number(r, u))
+                return false;
+            v = T(u);
+            return true;
+        }
+
+        if constexpr (rf::is_enum_introspectable<T>)
+        {
+            cc::string_view raw;
+            bool has_escapes;
+            return r.read_raw_string(raw, has_escapes) && !has_escapes && rf::enum_from_string(raw, v);
+        }
+        else
+            return false;
+    }
+    else if constexpr (std::is_same_v<T, cc::string_view>)
+    {
+        // references the text in place, which is only possible without escapes
+        bool has_escapes;
+        return r.read_raw_string(v, has_escapes) && !has_escapes;
+    }
+    else if constexpr (is_json_string_target<T>)
+    {
+        cc::string_view raw;
+        bool has_escapes;
+        if (!r.read_raw_string(raw, has_escapes))
+            return false;
+
+        if (!has_escapes)
+        {
+            v = raw;
+            return true;
+        }
+
+        v = cc::string_view();
+        return json_unescape(v, raw);
+    }
+    else if constexpr (rf::is_introspectable<T>)
+    {
+        if (!r.consume('{'))
+            return false;
+        if (r.consume('}'))
+            return true;
+
+        auto const raw = reinterpret_cast<std::byte*>(&v);
+        if constexpr (has_member_name_table<T>)
+        {
+            // names are looked up in a compile-time table, only the member offsets are a runtime lookup
+            auto const& offsets = rf::member_offsets<T>();
+            if (offsets.is_valid)
+                return json_read_object_members(r,
+                                                [&](cc::string_view key)
+                                                {
+                                                    auto const idx = member_name_table<T>.find(key);
+                                                    if (idx < 0 || json_read_fns<T>[idx] == nullptr)
+                                                        return r.skip_value();
+                                                    return json_read_fns<T>[idx](r, raw + offsets[idx]);
+                                                });
+        }
+        else if constexpr (std::is_default_constructible_v<T>)
+        {
+            auto const& table = cached_json_member_table<T>();
+            if (table.is_valid)
+                return json_read_object_members(r,
+                                                [&](cc::string_view key)
+                                                {
+                                                    auto const idx = table.find(key);
+                                                    if (idx < 0)
+                                                        return r.skip_value();
+                                                    return table.read_fns[idx](r, raw + table.offsets[idx]);
+                                                });
+        }
+
+        // fallback for types that are not default constructible (there are no member offsets)
+        // and for introspect functions that list non-subobjects
+        return json_read_object_members(r, [&](cc::string_view key) { return json_read_member_linear(r, v, key); });
+    }
+    else if constexpr (cc::is_any_range<T>)
+    {
+        if (!r.consume('['))
+            return false;
+
+        if constexpr (has_resize_t<T>::value)
+        {
+            v.resize(0);
+            if (r.consume(']'))
+                return true;
+
+            do
+            {
+                if constexpr (has_emplace_back_t<T>::value)
+                {
+                    if (!impl_read_json(r, v.emplace_back()))
+                        return false;
+                }
+                else
+                {
+                    auto const size = range_size(v);
+                    v.resize(size + 1);
+                    if (!impl_read_json(r, *std::next(std::begin(v), size)))
+                        return false;
+                }
+            } while (r.consume(','));
+        }
+        else
+        {
+            // fixed-size ranges must match
+            auto it = std::begin(v);
+            auto const end = std::end(v);
+            if (it == end)
+                return r.consume(']');
+
+            do
+            {
+                if (it == end || !impl_read_json(r, *it))
+                    return false;
+                ++it;
+            } while (r.consume(','));
+
+            if (it != end)
+                return false;
+        }
+
+        return r.consume(']');
+    }
+    else
+    {
+        static_assert(cc::always_false<T>, "type cannot be read from JSON (must be arithmetic, enum, string, introspectable, or a range)");
+        return false;
+    }
+}
+}
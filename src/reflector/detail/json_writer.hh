@@ -0,0 +1,217 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <type_traits>
+
+#include <clean-core/always_false.hh>
+#include <clean-core/is_range.hh>
+#include <clean-core/string_view.hh>
+
+#include <reflector/detail/range_traits.hh>
+#include <reflector/detail/stringify.hh>
+#include <reflector/enums.hh>
+#include <reflector/introspect.hh>
+#include <reflector/sink.hh>
+
+namespace rf::detail
+{
+/// true iff c must be escaped inside a JSON string
+constexpr bool json_needs_escape(char c) { return (unsigned char)c < 0x20 || c == '"' || c == '\\'; }
+
+/// appends s to the sink with JSON string escaping (without the surrounding quotes)
+/// NOTE: runs of characters that need no escaping are appended in bulk
+template <class Sink>
+void json_append_escaped(Sink& sink, cc::string_view s)
+{
+    auto const data = s.data();
+    auto const size = s.size();
+
+    size_t run_start = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        auto const c = data[i];
+        if (!json_needs_escape(c))
+            continue;
+
+        if (i > run_start)
+            sink_append(sink, cc::string_view(data + run_start, i - run_start));
+        run_start = i + 1;
+
+        switch (c)
+        {
+        case '"':
+            sink_append(sink, "\\\"");
+            break;
+        case '\\':
+            sink_append(sink, "\\\\");
+            break;
+        case '\b':
+            sink_append(sink, "\\b");
+            break;
+        case '\f':
+            sink_append(sink, "\\f");
+            break;
+        case '\n':
+            sink_append(sink, "\\n");
+            break;
+        case '\r':
+            sink_append(sink, "\\r");
+            break;
+        case '\t':
+            sink_append(sink, "\\t");
+            break;
+        default:
+        {
+            constexpr char hex[] = "0123456789abcdef";
+            char const esc[] = {'\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF]};
+            sink_append(sink, cc::string_view(esc, sizeof(esc)));
+        }
+        }
+    }
+
+    if (size > run_start)
+        sink_append(sink, cc::string_view(data + run_start, size - run_start));
+}
+
+/// sink adaptor that escapes everything appended to it
+/// (used to write arbitrary to_string output as a JSON string without a temporary)
+template <class Sink>
+struct json_escaping_sink
+{
+    Sink& sink;
+
+    void append(char const* data, size_t size) { json_append_escaped(sink, cc::string_view(data, size)); }
+};
+
+template <class Sink>
+void json_append_string(Sink& sink, cc::string_view s)
+{
+    sink_append(sink, '"');
+    json_append_escaped(sink, s);
+    sink_append(sink, '"');
+}
+
+template <class T, class = void>
+struct can_write_json_t : std::false_type
+{
+};
+
+template <class T>
+constexpr bool is_json_primitive = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_convertible_v<T const&, cc::string_view>;
+
+template <class T>
+struct can_write_json_t<T, std::enable_if_t<is_json_primitive<T> || rf::is_introspectable<T>>> : std::true_type
+{
+};
+template <class T>
+struct can_write_json_t<T, std::enable_if_t<!is_json_primitive<T> && !rf::is_introspectable<T> && cc::is_any_range<T>>>
+  : can_write_json_t<range_element_t<T>>
+{
+};
+template <class T>
+struct can_write_json_t<T, std::enable_if_t<!is_json_primitive<T> && !rf::is_introspectable<T> && !cc::is_any_range<T>>>
+  : ::rf_external_detail::has_to_string_t<T>
+{
+};
+
+template <class Sink, class T>
+void impl_write_json(Sink& sink, T const& v);
+
+template <class Sink>
+struct json_object_writer
+{
+    Sink& sink;
+    bool first = true;
+
+    template <class T, class... Args>
+    void operator()(T const& v, cc::string_view name, Args&&...)
+    {
+        if constexpr (!is_skipped<no_serialize_t, Args...>)
+        {
+            sink_append(sink, first ? "\"" : ",\"");
+            first = false;
+
+            json_append_escaped(sink, name);
+            sink_append(sink, "\":");
+            impl_write_json(sink, v);
+        }
+    }
+};
+
+template <class Sink, class T>
+void impl_write_json(Sink& sink, T const& v)
+{
+    if constexpr (std::is_same_v<T, bool>)
+        sink_append(sink, v ? "true" : "false");
+    else if constexpr (std::is_same_v<T, char>)
+        json_append_string(sink, cc::string_view(&v, 1));
+    else if constexpr (std::is_integral_v<T>)
+    {
+        char buffer[24]; // enough for 64 bit integers incl. sign
+        auto const res = std::to_chars(buffer, buffer + sizeof(buffer), v);
+        sink_append(sink, cc::string_view(buffer, res.ptr - buffer));
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        // JSON has no representation for inf and nan
+        if (!std::isfinite(v))
+        {
+            sink_append(sink, "null");
+            return;
+        }
+
+        // shortest representation that round-trips
+        char buffer[64];
+        auto const res = std::to_chars(buffer, buffer + sizeof(buffer), v);
+        sink_append(sink, cc::string_view(buffer, res.ptr - buffer));
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        if constexpr (rf::is_enum_introspectable<T>)
+        {
+            auto const idx = enum_index_of(v);
+            if (idx != enum_invalid_index)
+            {
+                json_append_string(sink, rf::enum_names<T>[idx]);
+                return;
+            }
+        }
+
+        // unregistered values are written as their underlying integer
+        impl_write_json(sink, std::underlying_type_t<T>(v));
+    }
+    else if constexpr (std::is_convertible_v<T const&, cc::string_view>)
+        json_append_string(sink, cc::string_view(v));
+    else if constexpr (rf::is_introspectable<T>)
+    {
+        sink_append(sink, '{');
+        rf::do_introspect(json_object_writer<Sink>{sink}, const_cast<T&>(v)); // promise we will not change v
+        sink_append(sink, '}');
+    }
+    else if constexpr (cc::is_any_range<T>)
+    {
+        sink_append(sink, '[');
+        auto first = true;
+        for (auto const& e : v)
+        {
+            if (!first)
+                sink_append(sink, ',');
+            first = false;
+
+            impl_write_json(sink, e);
+        }
+        sink_append(sink, ']');
+    }
+    else if constexpr (::rf_external_detail::has_to_string_t<T>::value)
+    {
+        // everything else is written as the JSON string of its to_string representation
+        sink_append(sink, '"');
+        auto escaped = json_escaping_sink<Sink>{sink};
+        ::rf_external_detail::impl_to_string(escaped, v, ::rf_external_detail::to_string_max_prio);
+        sink_append(sink, '"');
+    }
+    else
+        static_assert(cc::always_false<T>, "type cannot be written as JSON (must be arithmetic, enum, string, introspectable, a range, or have a to_string)");
+}
+}
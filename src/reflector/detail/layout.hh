@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include <clean-core/vector.hh>
+
+#include <reflector/annotations.hh>
+#include <reflector/introspect.hh>
+#include <reflector/members.hh>
+
+namespace rf::detail
+{
+template <class T>
+constexpr bool compute_is_layout_analyzable()
+{
+    // NOTE: nested so that the constexpr check is only instantiated for introspectable types
+    if constexpr (rf::is_introspectable<T> && std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>)
+        return is_constexpr_introspectable<T>;
+    else
+        return false;
+}
+
+/// true iff T can be introspected in a constant expression without side effects
+/// (a prerequisite for the compile time layout checks below)
+/// types with a non-constexpr introspect are not analyzable and thus use the memberwise paths
+template <class T>
+constexpr bool is_layout_analyzable = compute_is_layout_analyzable<T>();
+
+template <template <class> class Trait, class Annotation>
+struct MemberTraitChecker
+{
+    bool all_members = true;
+    template <class M, class... Args>
+    constexpr void operator()(M&, Args&&...)
+    {
+        // members skipped by the operation must not be part of a bulk operation
+        if constexpr (is_skipped<Annotation, Args...>)
+            all_members = false;
+        else
+            all_members = all_members && Trait<std::remove_cv_t<M>>::value;
+    }
+};
+
+/// returns true iff the introspected members of T exactly cover the sizeof(T) bytes of T
+/// and all members satisfy Trait<M>::value and are not skipped by the operation that honors Annotation
+/// NOTE: assumes that introspect lists distinct subobjects (i.e. no member is listed twice)
+///       only call this for types with is_layout_analyzable<T>
+template <class T, template <class> class Trait, class Annotation>
+constexpr bool members_tile()
+{
+    // the size check is shared by all traits, types with padding skip the per-trait pass
+    if constexpr (static_type_info_of<T>.member_size_sum != sizeof(T))
+        return false;
+    else
+    {
+        // NOTE: a named functor (instead of a lambda) is instantiated once per member type, not once per T
+        T v = {};
+        auto checker = MemberTraitChecker<Trait, Annotation>{};
+        rf::do_introspect(checker, v);
+        return checker.all_members;
+    }
+}
+
+/// a contiguous byte range of an object that is processed either in bulk (fn == nullptr) or via fn
+template <class FnT>
+struct member_run
+{
+    size_t offset;
+    size_t size;
+    FnT fn;
+};
+
+/// offset-based plan for applying an operation to the members of an object
+/// adjacent bytewise members are merged into a single run
+/// NOTE: member offsets are the same for all objects of a type, so a plan is built once per type and cached
+///       (from rf::member_offsets, i.e. from a value-initialized T)
+template <class FnT>
+struct member_runs
+{
+    cc::vector<member_run<FnT>> runs;
+    size_t member_count = 0;
+    bool is_valid = true; ///< false if some introspected member is not a subobject
+
+    /// running the plan only pays off if members were actually merged (or skipped)
+    [[nodiscard]] bool is_beneficial() const { return is_valid && runs.size() < member_count; }
+};
+
+template <class FnT, class Policy>
+struct MemberRunBuilder
+{
+    member_runs<FnT>& plan;
+    member_offset_table const& offsets;
+
+    template <class M, class... Args>
+    void operator()(M const&, Args&&...)
+    {
+        auto const offset = offsets[plan.member_count];
+        ++plan.member_count;
+
+        // skipped members get no run (and thus separate the runs of their neighbors)
+        // NOTE: their types are not required to support the operation
+        if constexpr (!is_skipped<typename Policy::annotation, Args...>)
+            add_run<M>(offset);
+    }
+
+    template <class M>
+    void add_run(size_t offset)
+    {
+        if constexpr (Policy::template is_bytewise<M>)
+        {
+            if (!plan.runs.empty())
+            {
+                auto& last = plan.runs.back();
+                if (last.fn == nullptr && last.offset + last.size == offset)
+                {
+                    last.size += sizeof(M);
+                    return;
+                }
+            }
+            plan.runs.push_back({offset, sizeof(M), nullptr});
+        }
+        else
+        {
+            plan.runs.push_back({offset, sizeof(M), &Policy::template apply<M>});
+        }
+    }
+};
+
+/// builds the run plan for the members of T
+/// types that are not default constructible get an invalid plan (and thus use the memberwise paths)
+/// Policy must provide:
+///   using annotation = <annotation tag of the operation>; (e.g. no_hash_t)
+///   template <class M> static constexpr bool is_bytewise;
+///   template <class M> static <FnT-compatible function> apply;
+template <class FnT, class Policy, class T>
+member_runs<FnT> build_member_runs()
+{
+    member_runs<FnT> plan;
+    if constexpr (std::is_default_constructible_v<T>)
+    {
+        auto const& offsets = rf::member_offsets<T>();
+        plan.is_valid = offsets.is_valid;
+        if (plan.is_valid)
+        {
+            T obj = {};
+            rf::do_introspect(MemberRunBuilder<FnT, Policy>{plan, offsets}, obj);
+        }
+    }
+    else
+        plan.is_valid = false;
+    return plan;
+}
+
+/// returns the cached run plan of T
+template <class FnT, class Policy, class T>
+member_runs<FnT> const& cached_member_runs()
+{
+    static auto const plan = build_member_runs<FnT, Policy, T>();
+    return plan;
+}
+}
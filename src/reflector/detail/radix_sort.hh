@@ -0,0 +1,406 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#include <clean-core/always_false.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/introspect.hh>
+
+namespace rf::detail
+{
+// radix sort keys are byte strings that compare lexicographically (memcmp) in the same order as the values they are derived from
+// each arithmetic value is mapped to an unsigned integer with the same order and stored big-endian
+// composed values (introspectable types, multiple sort members) are the concatenation of their parts
+
+/// NOTE: integers wider than 64 bit (e.g. __int128 in gnu++ mode) are not supported
+template <class T>
+constexpr bool is_radix_arithmetic = (std::is_integral_v<T> && sizeof(T) <= 8) || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <size_t Size>
+using radix_uint_t = std::conditional_t<Size == 1, uint8_t, std::conditional_t<Size == 2, uint16_t, std::conditional_t<Size == 4, uint32_t, uint64_t>>>;
+
+/// order-preserving map to an unsigned integer of the same size
+template <class T>
+radix_uint_t<sizeof(T)> radix_transform(T v)
+{
+    static_assert(sizeof(T) <= 8, "radix keys of arithmetic types are at most 64 bit");
+    using U = radix_uint_t<sizeof(T)>;
+    constexpr auto sign_bit = U(U(1) << (sizeof(T) * 8 - 1));
+
+    U u;
+    std::memcpy(&u, &v, sizeof(T));
+
+    if constexpr (std::is_same_v<T, bool> || std::is_unsigned_v<T>)
+        return u;
+    else if constexpr (std::is_integral_v<T>)
+        return U(u ^ sign_bit); // two's complement: flipping the sign bit makes negatives sort first
+    else
+        return (u & sign_bit) ? U(~u) : U(u | sign_bit); // negative floats: reverse their order, positive floats: above all negatives
+}
+
+/// number of key bytes of v
+template <class T>
+size_t radix_key_size(T const& v)
+{
+    if constexpr (std::is_enum_v<T>)
+        return sizeof(T);
+    else if constexpr (is_radix_arithmetic<T>)
+        return sizeof(T);
+    else if constexpr (rf::is_introspectable<T>)
+    {
+        size_t size = 0;
+        rf::do_introspect(
+            [&](auto const& m, auto&&... annotations)
+            {
+                if constexpr (!is_skipped<no_compare_t, decltype(annotations)...>)
+                    size += radix_key_size(m);
+            },
+            const_cast<T&>(v)); // promise we will not change v
+        return size;
+    }
+    else
+    {
+        static_assert(cc::always_false<T>, "radix sort keys must be integers (up to 64 bit), bool, float, double, enums, or introspectable types of those");
+        return 0;
+    }
+}
+
+/// writes the key bytes of v to dst and advances dst
+template <class T>
+void write_radix_key(T const& v, std::byte*& dst)
+{
+    if constexpr (std::is_enum_v<T>)
+        write_radix_key(std::underlying_type_t<T>(v), dst);
+    else if constexpr (is_radix_arithmetic<T>)
+    {
+        auto const u = radix_transform(v);
+        for (size_t i = 0; i < sizeof(T); ++i)
+            dst[i] = std::byte(u >> (8 * (sizeof(T) - 1 - i)));
+        dst += sizeof(T);
+    }
+    else if constexpr (rf::is_introspectable<T>)
+        rf::do_introspect(
+            [&](auto const& m, auto&&... annotations)
+            {
+                if constexpr (!is_skipped<no_compare_t, decltype(annotations)...>)
+                    write_radix_key(m, dst);
+            },
+            const_cast<T&>(v)); // promise we will not change v
+    else
+        static_assert(cc::always_false<T>, "radix sort keys must be integers (up to 64 bit), bool, float, double, enums, or introspectable types of those");
+}
+
+/// calls fn(begin, end, thread_index) for thread_count chunks of [0, count) in parallel
+template <class F>
+void radix_parallel_chunks(size_t count, size_t thread_count, F&& fn)
+{
+    if (thread_count <= 1)
+    {
+        fn(size_t(0), count, size_t(0));
+        return;
+    }
+
+    cc::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    auto const chunk = (count + thread_count - 1) / thread_count;
+    for (size_t t = 1; t < thread_count; ++t)
+    {
+        auto const begin = t * chunk < count ? t * chunk : count;
+        auto const end = begin + chunk < count ? begin + chunk : count;
+        threads.emplace_back([&fn, begin, end, t] { fn(begin, end, t); });
+    }
+    fn(size_t(0), chunk < count ? chunk : count, size_t(0));
+
+    for (auto& th : threads)
+        th.join();
+}
+
+/// stable LSD radix sort of records (key bytes followed by the big-endian uint32_t index)
+/// returns the buffer (records or scratch) that contains the sorted records
+/// NOTE: passes in which all records have the same byte are skipped
+inline std::byte* radix_lsd_sort(std::byte* records, std::byte* scratch, size_t count, size_t key_size, size_t thread_count)
+{
+    auto const stride = key_size + sizeof(uint32_t);
+    auto src = records;
+    auto dst = scratch;
+
+    cc::vector<size_t> counts;
+    counts.resize(thread_count * 256);
+
+    for (auto pass = key_size; pass-- > 0;)
+    {
+        // per-thread histograms
+        for (auto& c : counts)
+            c = 0;
+        radix_parallel_chunks(count, thread_count,
+                              [&](size_t begin, size_t end, size_t t)
+                              {
+                                  auto const c = counts.data() + t * 256;
+                                  for (size_t i = begin; i < end; ++i)
+                                      ++c[size_t(src[i * stride + pass])];
+                              });
+
+        // skip passes that would not reorder anything
+        auto is_trivial = false;
+        for (size_t b = 0; b < 256; ++b)
+        {
+            size_t bucket_size = 0;
+            for (size_t t = 0; t < thread_count; ++t)
+                bucket_size += counts[t * 256 + b];
+            if (bucket_size == count)
+                is_trivial = true;
+            if (bucket_size != 0)
+                break;
+        }
+        if (is_trivial)
+            continue;
+
+        // exclusive prefix sum in (bucket, thread) order keeps the sort stable
+        size_t offset = 0;
+        for (size_t b = 0; b < 256; ++b)
+            for (size_t t = 0; t < thread_count; ++t)
+            {
+                auto const c = counts[t * 256 + b];
+                counts[t * 256 + b] = offset;
+                offset += c;
+            }
+
+        radix_parallel_chunks(count, thread_count,
+                              [&](size_t begin, size_t end, size_t t)
+                              {
+                                  auto const c = counts.data() + t * 256;
+                                  for (size_t i = begin; i < end; ++i)
+                                  {
+                                      auto const rec = src + i * stride;
+                                      std::memcpy(dst + c[size_t(rec[pass])]++ * stride, rec, stride);
+                                  }
+                              });
+
+        auto const tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    return src;
+}
+
+/// below this size, MSD buckets are finished by insertion sort
+constexpr size_t radix_small_sort_size = 32;
+
+/// insertion sort of records by their bytes [pos, stride)
+/// (records are unique because they end with their index, so the result is stable)
+inline void radix_small_sort(std::byte* records, size_t count, size_t stride, size_t pos, std::byte* tmp)
+{
+    for (size_t i = 1; i < count; ++i)
+    {
+        auto const rec = records + i * stride;
+        if (std::memcmp(rec - stride + pos, rec + pos, stride - pos) <= 0)
+            continue;
+
+        std::memcpy(tmp, rec, stride);
+        auto j = i;
+        while (j > 0 && std::memcmp(records + (j - 1) * stride + pos, tmp + pos, stride - pos) > 0)
+            --j;
+        std::memmove(records + (j + 1) * stride, records + j * stride, (i - j) * stride);
+        std::memcpy(records + j * stride, tmp, stride);
+    }
+}
+
+/// stable MSD radix sort of records (key bytes followed by the big-endian uint32_t index), sorted in place
+/// only the bytes that distinguish records are processed, which makes it preferable for long (composite) keys
+/// NOTE: tmp must provide stride bytes
+inline void radix_msd_sort(std::byte* records, std::byte* scratch, size_t count, size_t key_size, size_t pos, std::byte* tmp)
+{
+    auto const stride = key_size + sizeof(uint32_t);
+
+    for (; pos < key_size; ++pos)
+    {
+        if (count <= radix_small_sort_size)
+        {
+            radix_small_sort(records, count, stride, pos, tmp);
+            return;
+        }
+
+        size_t counts[256] = {};
+        for (size_t i = 0; i < count; ++i)
+            ++counts[size_t(records[i * stride + pos])];
+
+        // all records share this byte: continue with the next one without moving anything
+        if (counts[size_t(records[pos])] == count)
+            continue;
+
+        size_t offsets[256];
+        size_t offset = 0;
+        for (size_t b = 0; b < 256; ++b)
+        {
+            offsets[b] = offset;
+            offset += counts[b];
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto const rec = records + i * stride;
+            std::memcpy(scratch + offsets[size_t(rec[pos])]++ * stride, rec, stride);
+        }
+        std::memcpy(records, scratch, count * stride);
+
+        size_t start = 0;
+        for (size_t b = 0; b < 256; ++b)
+        {
+            if (counts[b] > 1)
+                radix_msd_sort(records + start * stride, scratch + start * stride, counts[b], key_size, pos + 1, tmp);
+            start += counts[b];
+        }
+        return;
+    }
+}
+
+/// up to this key size, LSD passes (streaming over all records) beat MSD recursion
+constexpr size_t radix_lsd_max_key_size = 4;
+
+/// sorts records (key bytes followed by the big-endian uint32_t index)
+/// returns the buffer (records or scratch) that contains the sorted records
+inline std::byte* radix_sort_records(std::byte* records, std::byte* scratch, size_t count, size_t key_size, size_t thread_count)
+{
+    if (key_size <= radix_lsd_max_key_size)
+        return radix_lsd_sort(records, scratch, count, key_size, thread_count);
+
+    auto const stride = key_size + sizeof(uint32_t);
+    cc::vector<std::byte> tmp;
+    tmp.resize(stride * thread_count);
+
+    if (thread_count <= 1)
+    {
+        radix_msd_sort(records, scratch, count, key_size, 0, tmp.data());
+        return records;
+    }
+
+    // parallel: partition by the first distinguishing byte in parallel, then sort the buckets on all threads
+    size_t pos = 0;
+    for (; pos < key_size; ++pos)
+    {
+        auto shared = true;
+        for (size_t i = 1; i < count && shared; ++i)
+            shared = records[i * stride + pos] == records[pos];
+        if (!shared)
+            break;
+    }
+    if (pos == key_size)
+        return records; // all keys are equal
+
+    cc::vector<size_t> counts;
+    counts.resize(thread_count * 256);
+    radix_parallel_chunks(count, thread_count,
+                          [&](size_t begin, size_t end, size_t t)
+                          {
+                              auto const c = counts.data() + t * 256;
+                              for (size_t i = begin; i < end; ++i)
+                                  ++c[size_t(records[i * stride + pos])];
+                          });
+
+    size_t bucket_starts[257];
+    size_t offset = 0;
+    for (size_t b = 0; b < 256; ++b)
+    {
+        bucket_starts[b] = offset;
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            auto const c = counts[t * 256 + b];
+            counts[t * 256 + b] = offset;
+            offset += c;
+        }
+    }
+    bucket_starts[256] = count;
+
+    radix_parallel_chunks(count, thread_count,
+                          [&](size_t begin, size_t end, size_t t)
+                          {
+                              auto const c = counts.data() + t * 256;
+                              for (size_t i = begin; i < end; ++i)
+                              {
+                                  auto const rec = records + i * stride;
+                                  std::memcpy(scratch + c[size_t(rec[pos])]++ * stride, rec, stride);
+                              }
+                          });
+
+    // buckets are distributed round-robin (the partition already balances large inputs reasonably)
+    radix_parallel_chunks(thread_count, thread_count,
+                          [&](size_t, size_t, size_t t)
+                          {
+                              for (auto b = t; b < 256; b += thread_count)
+                              {
+                                  auto const start = bucket_starts[b];
+                                  auto const size = bucket_starts[b + 1] - start;
+                                  if (size > 1)
+                                      radix_msd_sort(scratch + start * stride, records + start * stride, size, key_size, pos + 1, tmp.data() + t * stride);
+                              }
+                          });
+    return scratch;
+}
+
+/// reorders values such that values[i] = old values[order(i)]
+template <class T, class OrderF>
+void radix_apply_permutation(T* values, size_t count, OrderF&& order)
+{
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        cc::vector<std::byte> tmp;
+        tmp.resize(count * sizeof(T));
+        for (size_t i = 0; i < count; ++i)
+            std::memcpy(tmp.data() + i * sizeof(T), values + order(i), sizeof(T));
+        std::memcpy(static_cast<void*>(values), tmp.data(), count * sizeof(T));
+    }
+    else
+    {
+        cc::vector<T> tmp;
+        tmp.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            tmp.emplace_back(static_cast<T&&>(values[order(i)]));
+        for (size_t i = 0; i < count; ++i)
+            values[i] = static_cast<T&&>(tmp[i]);
+    }
+}
+
+/// sorts values by the keys written by write_key(value, dst) (each exactly key_size bytes)
+template <class T, class WriteKeyF>
+void radix_sort_impl(T* values, size_t count, size_t key_size, size_t thread_count, WriteKeyF&& write_key)
+{
+    auto const stride = key_size + sizeof(uint32_t);
+
+    cc::vector<std::byte> buffer;
+    buffer.resize(2 * count * stride);
+    auto const records = buffer.data();
+    auto const scratch = buffer.data() + count * stride;
+
+    radix_parallel_chunks(count, thread_count,
+                          [&](size_t begin, size_t end, size_t)
+                          {
+                              for (size_t i = begin; i < end; ++i)
+                              {
+                                  auto dst = records + i * stride;
+                                  write_key(values[i], dst);
+
+                                  // big-endian index: makes records unique and memcmp-ordered by original position
+                                  for (size_t b = 0; b < sizeof(uint32_t); ++b)
+                                      dst[b] = std::byte(uint32_t(i) >> (8 * (sizeof(uint32_t) - 1 - b)));
+                              }
+                          });
+
+    auto const sorted = radix_sort_records(records, scratch, count, key_size, thread_count);
+
+    radix_apply_permutation(values, count,
+                            [&](size_t i)
+                            {
+                                auto const rec = sorted + i * stride + key_size;
+                                uint32_t idx = 0;
+                                for (size_t b = 0; b < sizeof(uint32_t); ++b)
+                                    idx = (idx << 8) | uint32_t(rec[b]);
+                                return idx;
+                            });
+}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+
+namespace rf::detail
+{
+template <class T>
+using range_element_t = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(std::declval<T const&>()))>>;
+
+/// true iff std::data and std::size can be used to access T as a contiguous array
+template <class T, class = void>
+struct is_contiguous_range_t : std::false_type
+{
+};
+template <class T>
+struct is_contiguous_range_t<T, std::void_t<decltype(std::data(std::declval<T const&>())), decltype(std::size(std::declval<T const&>()))>>
+  : std::is_pointer<decltype(std::data(std::declval<T const&>()))>
+{
+};
+
+template <class T, class = void>
+struct has_range_size_t : std::false_type
+{
+};
+template <class T>
+struct has_range_size_t<T, std::void_t<decltype(std::size(std::declval<T const&>()))>> : std::true_type
+{
+};
+
+template <class T, class = void>
+struct has_resize_t : std::false_type
+{
+};
+template <class T>
+struct has_resize_t<T, std::void_t<decltype(std::declval<T&>().resize(size_t(0)))>> : std::true_type
+{
+};
+
+template <class T>
+size_t range_size(T const& range)
+{
+    if constexpr (has_range_size_t<T>::value)
+        return size_t(std::size(range));
+    else
+    {
+        size_t cnt = 0;
+        for (auto it = std::begin(range), end = std::end(range); it != end; ++it)
+            ++cnt;
+        return cnt;
+    }
+}
+}
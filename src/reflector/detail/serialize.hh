@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <clean-core/always_false.hh>
+#include <clean-core/is_range.hh>
+
+#include <reflector/detail/layout.hh>
+#include <reflector/detail/range_traits.hh>
+#include <reflector/introspect.hh>
+
+namespace rf::detail
+{
+template <class Writer, class T>
+void impl_serialize(Writer& writer, T const& v);
+
+template <class Reader, class T>
+[[nodiscard]] bool impl_deserialize(Reader& reader, T& v);
+
+template <class T>
+struct is_bytewise_serializable_t;
+
+/// true iff T can be written by copying its object representation
+/// NOTE: unlike for comparison or hashing, floating point values are fine here
+///       padding is not (the output should be deterministic and not leak uninitialized memory)
+///       types with a non-constexpr introspect are not layout analyzable and are written memberwise (which yields the same bytes)
+template <class T>
+constexpr bool compute_is_bytewise_serializable()
+{
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        return true;
+    else if constexpr (std::is_array_v<T>)
+        return is_bytewise_serializable_t<std::remove_extent_t<T>>::value;
+    else if constexpr (std::is_class_v<T> && is_layout_analyzable<T>)
+        return members_tile<T, is_bytewise_serializable_t, no_serialize_t>();
+    else
+        return false;
+}
+
+template <class T>
+struct is_bytewise_serializable_t : std::bool_constant<compute_is_bytewise_serializable<T>()>
+{
+};
+
+template <class T>
+constexpr bool is_bytewise_serializable = is_bytewise_serializable_t<T>::value;
+
+template <class T, class = void>
+struct can_serialize_t : std::false_type
+{
+};
+template <class T>
+struct can_serialize_t<T, std::enable_if_t<is_bytewise_serializable<T> || rf::is_introspectable<T>>> : std::true_type
+{
+};
+template <class T>
+struct can_serialize_t<T, std::enable_if_t<!is_bytewise_serializable<T> && !rf::is_introspectable<T> && cc::is_any_range<T>>>
+  : can_serialize_t<range_element_t<T>>
+{
+};
+
+template <class Reader, class = void>
+struct has_reader_remaining_t : std::false_type
+{
+};
+template <class Reader>
+struct has_reader_remaining_t<Reader, std::void_t<decltype(size_t(std::declval<Reader const&>().remaining()))>> : std::true_type
+{
+};
+
+template <class Writer>
+struct serialize_policy
+{
+    using annotation = no_serialize_t;
+
+    template <class M>
+    static constexpr bool is_bytewise = is_bytewise_serializable<M>;
+
+    template <class M>
+    static void apply(Writer& writer, void const* v)
+    {
+        impl_serialize(writer, *static_cast<M const*>(v));
+    }
+};
+
+template <class Reader>
+struct deserialize_policy
+{
+    using annotation = no_serialize_t;
+
+    template <class M>
+    static constexpr bool is_bytewise = is_bytewise_serializable<M>;
+
+    template <class M>
+    static bool apply(Reader& reader, void* v)
+    {
+        return impl_deserialize(reader, *static_cast<M*>(v));
+    }
+};
+
+template <class Writer>
+using serialize_fn = void (*)(Writer&, void const*);
+
+template <class Reader>
+using deserialize_fn = bool (*)(Reader&, void*);
+
+// NOTE: named inspectors (instead of lambdas) are instantiated once per member type, not once per introspected type
+
+template <class Writer>
+struct serialize_inspector
+{
+    Writer& writer;
+
+    template <class M, class... Args>
+    void operator()(M const& m, Args&&...)
+    {
+        if constexpr (!is_skipped<no_serialize_t, Args...>)
+            impl_serialize(writer, m);
+    }
+};
+
+template <class Reader>
+struct deserialize_inspector
+{
+    Reader& reader;
+    bool ok = true;
+
+    template <class M, class... Args>
+    void operator()(M& m, Args&&...)
+    {
+        if constexpr (!is_skipped<no_serialize_t, Args...>)
+        {
+            if (ok)
+                ok = impl_deserialize(reader, m);
+        }
+    }
+};
+
+template <class T>
+size_t min_serialized_size();
+
+struct MinSerializedSizeSum
+{
+    size_t size = 0;
+
+    template <class M, class... Args>
+    void operator()(M&, Args&&...)
+    {
+        if constexpr (!is_skipped<no_serialize_t, Args...>)
+            size += min_serialized_size<std::remove_cv_t<M>>();
+    }
+};
+
+/// lower bound for the number of bytes written by impl_serialize for any value of T (0 if unknown)
+/// used to reject corrupted range sizes before allocating
+template <class T>
+size_t min_serialized_size()
+{
+    if constexpr (is_bytewise_serializable<T>)
+        return sizeof(T);
+    else if constexpr (rf::is_introspectable<T>)
+    {
+        if constexpr (std::is_default_constructible_v<T>)
+        {
+            // computed once per type from a value-initialized T
+            static auto const size = []
+            {
+                MinSerializedSizeSum s;
+                T t = {};
+                rf::do_introspect(s, t);
+                return s.size;
+            }();
+            return size;
+        }
+        else
+            return 0;
+    }
+    else if constexpr (cc::is_any_range<T>)
+        return sizeof(uint64_t); // the size prefix
+    else
+        return 0;
+}
+
+template <class Writer, class T>
+void impl_serialize(Writer& writer, T const& v)
+{
+    if constexpr (is_bytewise_serializable<T>)
+    {
+        writer.write(&v, sizeof(T));
+    }
+    else if constexpr (rf::is_introspectable<T>)
+    {
+        // one write per run of adjacent bytewise members (the output is the same as writing them one by one)
+        auto const& plan = cached_member_runs<serialize_fn<Writer>, serialize_policy<Writer>, T>();
+        if (plan.is_beneficial())
+        {
+            auto const raw = reinterpret_cast<std::byte const*>(&v);
+            for (auto const& r : plan.runs)
+            {
+                if (r.fn)
+                    r.fn(writer, raw + r.offset);
+                else
+                    writer.write(raw + r.offset, r.size);
+            }
+            return;
+        }
+
+        rf::do_introspect(serialize_inspector<Writer>{writer}, const_cast<T&>(v)); // promise we will not change v
+    }
+    else if constexpr (cc::is_any_range<T>)
+    {
+        using element_t = range_element_t<T>;
+
+        uint64_t const size = range_size(v);
+        writer.write(&size, sizeof(size));
+
+        if constexpr (is_contiguous_range_t<T>::value && is_bytewise_serializable<element_t>)
+            writer.write(std::data(v), size * sizeof(element_t));
+        else
+            for (auto const& e : v)
+                impl_serialize(writer, e);
+    }
+    else
+        static_assert(cc::always_false<T>, "type cannot be serialized (must be arithmetic, enum, introspectable, or a range)");
+}
+
+template <class Reader, class T>
+bool impl_deserialize(Reader& reader, T& v)
+{
+    if constexpr (is_bytewise_serializable<T>)
+    {
+        return reader.read(&v, sizeof(T));
+    }
+    else if constexpr (rf::is_introspectable<T>)
+    {
+        // one read per run of adjacent bytewise members, directly into the object
+        auto const& plan = cached_member_runs<deserialize_fn<Reader>, deserialize_policy<Reader>, T>();
+        if (plan.is_beneficial())
+        {
+            auto const raw = reinterpret_cast<std::byte*>(&v);
+            for (auto const& r : plan.runs)
+            {
+                auto const ok = r.fn ? r.fn(reader, raw + r.offset) : reader.read(raw + r.offset, r.size);
+                if (!ok)
+                    return false;
+            }
+            return true;
+        }
+
+        auto inspector = deserialize_inspector<Reader>{reader};
+        rf::do_introspect(inspector, v);
+        return inspector.ok;
+    }
+    else if constexpr (cc::is_any_range<T>)
+    {
+        using element_t = range_element_t<T>;
+        constexpr auto is_bulk = is_contiguous_range_t<T>::value && is_bytewise_serializable<element_t>;
+
+        uint64_t size = 0;
+        if (!reader.read(&size, sizeof(size)))
+            return false;
+
+        if constexpr (has_resize_t<T>::value)
+        {
+            // reject corrupted sizes before allocating
+            if constexpr (sizeof(size_t) < sizeof(uint64_t))
+                if (size > std::numeric_limits<size_t>::max())
+                    return false;
+
+            // NOTE: elements of empty types take no bytes, so their count cannot be bounded by the remaining bytes
+            if constexpr (has_reader_remaining_t<Reader>::value)
+            {
+                auto const element_size = min_serialized_size<element_t>();
+                if (element_size > 0 && size > reader.remaining() / element_size)
+                    return false;
+            }
+
+            v.resize(size_t(size));
+        }
+        else if (size != range_size(v))
+            return false; // fixed-size ranges must match
+
+        if constexpr (is_bulk)
+            return reader.read(std::data(v), size_t(size) * sizeof(element_t));
+        else
+        {
+            for (auto& e : v)
+                if (!impl_deserialize(reader, e))
+                    return false;
+            return true;
+        }
+    }
+    else
+    {
+        static_assert(cc::always_false<T>, "type cannot be deserialized (must be arithmetic, enum, introspectable, or a range)");
+        return false;
+    }
+}
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <clean-core/assert.hh>
+#include <clean-core/string_view.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/detail/string_table.hh>
+#include <reflector/introspect.hh>
+#include <reflector/members.hh>
+
+namespace rf::detail
+{
+/// type-erased operations on arrays of a member type
+/// NOTE: trivially copyable members use memcpy/memmove
+struct soa_column_ops
+{
+    void (*default_construct)(void* dst, size_t n);
+    void (*copy_construct)(void* dst, void const* src, size_t n);
+    void (*move_construct)(void* dst, void* src, size_t n);
+    void (*copy_assign)(void* dst, void const* src, size_t n);
+    void (*move_assign_forward)(void* dst, void* src, size_t n); ///< for shifting elements to lower addresses
+    void (*destroy)(void* p, size_t n);
+};
+
+template <class M>
+struct soa_column_ops_impl
+{
+    static constexpr bool is_trivial = std::is_trivially_copyable_v<M>;
+
+    static void default_construct(void* dst, size_t n)
+    {
+        auto const d = static_cast<M*>(dst);
+        for (size_t i = 0; i < n; ++i)
+            new (d + i) M();
+    }
+    static void copy_construct(void* dst, void const* src, size_t n)
+    {
+        if constexpr (is_trivial)
+            std::memcpy(dst, src, n * sizeof(M));
+        else
+        {
+            auto const d = static_cast<M*>(dst);
+            auto const s = static_cast<M const*>(src);
+            for (size_t i = 0; i < n; ++i)
+                new (d + i) M(s[i]);
+        }
+    }
+    static void move_construct(void* dst, void* src, size_t n)
+    {
+        if constexpr (is_trivial)
+            std::memcpy(dst, src, n * sizeof(M));
+        else
+        {
+            auto const d = static_cast<M*>(dst);
+            auto const s = static_cast<M*>(src);
+            for (size_t i = 0; i < n; ++i)
+                new (d + i) M(std::move(s[i]));
+        }
+    }
+    static void copy_assign(void* dst, void const* src, size_t n)
+    {
+        if constexpr (is_trivial)
+            std::memcpy(dst, src, n * sizeof(M));
+        else
+        {
+            auto const d = static_cast<M*>(dst);
+            auto const s = static_cast<M const*>(src);
+            for (size_t i = 0; i < n; ++i)
+                d[i] = s[i];
+        }
+    }
+    static void move_assign_forward(void* dst, void* src, size_t n)
+    {
+        if constexpr (is_trivial)
+            std::memmove(dst, src, n * sizeof(M));
+        else
+        {
+            auto const d = static_cast<M*>(dst);
+            auto const s = static_cast<M*>(src);
+            for (size_t i = 0; i < n; ++i)
+                d[i] = std::move(s[i]);
+        }
+    }
+    static void destroy(void* p, size_t n)
+    {
+        if constexpr (!std::is_trivially_destructible_v<M>)
+        {
+            auto const d = static_cast<M*>(p);
+            for (size_t i = 0; i < n; ++i)
+                d[i].~M();
+        }
+    }
+
+    static constexpr soa_column_ops ops = {&default_construct, &copy_construct, &move_construct, &copy_assign, &move_assign_forward, &destroy};
+};
+
+/// unique per-type address used to check column types at runtime
+/// NOTE: must be inline, otherwise each TU has its own copy (and thus a different address)
+template <class M>
+inline constexpr char soa_type_tag = 0;
+
+struct soa_column_info
+{
+    cc::string_view name;
+    size_t offset;    ///< offset of the member in T
+    size_t size;      ///< sizeof(member)
+    size_t alignment; ///< alignment of the column array
+    void const* type; ///< &soa_type_tag<M>
+    soa_column_ops const* ops;
+};
+
+/// minimal alignment of each column array (a cache line, which also satisfies all SIMD loads)
+constexpr size_t soa_column_alignment = 64;
+
+/// per-type column description of an rf::soa_vector
+template <class T>
+struct soa_layout
+{
+    cc::vector<soa_column_info> columns;
+    cc::vector<cc::string_view> names;
+    cc::vector<string_table_entry> name_entries;
+    size_t name_capacity = 0;
+
+    T sample = {}; ///< used for computing offsets of member pointers
+
+    soa_layout()
+    {
+        auto const& offsets = rf::member_offsets<T>();
+        CC_ASSERT(offsets.is_valid && "all introspected members must be subobjects");
+
+        rf::do_introspect(
+            [&](auto& m, cc::string_view name, auto&&...)
+            {
+                using M = std::remove_reference_t<decltype(m)>;
+                static_assert(!std::is_array_v<M>, "C array members are not supported as soa columns (use cc::array)");
+
+                auto const alignment = alignof(M) > soa_column_alignment ? alignof(M) : soa_column_alignment;
+                columns.push_back({name, offsets[columns.size()], sizeof(M), alignment, &soa_type_tag<M>, &soa_column_ops_impl<M>::ops});
+                names.push_back(name);
+            },
+            sample);
+
+        name_capacity = string_table_capacity(names.size());
+        name_entries.resize(name_capacity);
+        for (size_t i = 0; i < names.size(); ++i)
+            string_table_insert<true>(name_entries, name_capacity, names, uint32_t(i));
+    }
+
+    /// returns the column index of the member with the given name or -1 if not found
+    int find(cc::string_view name) const { return string_table_find<true>(name_entries, name_capacity, names, name); }
+
+    /// returns the column index of the given member or -1 if it is not introspected
+    template <class M>
+    int find(M T::*member) const
+    {
+        auto const offset = size_t(reinterpret_cast<std::byte const*>(&(sample.*member)) - reinterpret_cast<std::byte const*>(&sample));
+        for (size_t i = 0; i < columns.size(); ++i)
+            if (columns[i].offset == offset && columns[i].type == &soa_type_tag<M>)
+                return int(i);
+        return -1;
+    }
+
+    static soa_layout const& get()
+    {
+        static soa_layout const layout;
+        return layout;
+    }
+};
+
+inline std::byte* soa_allocate(size_t bytes, size_t alignment) { return static_cast<std::byte*>(::operator new(bytes, std::align_val_t(alignment))); }
+inline void soa_free(std::byte* p, size_t alignment) { ::operator delete(p, std::align_val_t(alignment)); }
+}
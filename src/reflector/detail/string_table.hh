@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <clean-core/array.hh>
+#include <clean-core/string_view.hh>
+
+namespace rf::detail
+{
+// open-addressing hash tables for mapping strings to indices
+// the tables store the full 32 bit hash per entry, so a lookup performs a string compare only on a hash match
+// (i.e. at most one string compare unless two names have colliding 32 bit hashes)
+
+constexpr char ascii_to_lower(char c) { return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c; }
+
+/// FNV-1a
+template <bool CaseSensitive>
+constexpr uint32_t string_hash(cc::string_view s)
+{
+    uint32_t h = 2166136261u;
+    for (auto c : s)
+    {
+        if constexpr (!CaseSensitive)
+            c = ascii_to_lower(c);
+        h = (h ^ uint8_t(c)) * 16777619u;
+    }
+    return h;
+}
+
+template <bool CaseSensitive>
+constexpr bool string_equals(cc::string_view a, cc::string_view b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if constexpr (CaseSensitive)
+        {
+            if (a[i] != b[i])
+                return false;
+        }
+        else
+        {
+            if (ascii_to_lower(a[i]) != ascii_to_lower(b[i]))
+                return false;
+        }
+    }
+    return true;
+}
+
+struct string_table_entry
+{
+    static constexpr uint32_t empty_index = ~uint32_t(0);
+
+    uint32_t hash = 0;
+    uint32_t index = empty_index;
+};
+
+/// power of two with a load factor of at most 0.5
+constexpr size_t string_table_capacity(size_t name_count)
+{
+    size_t c = 2;
+    while (c < 2 * name_count)
+        c *= 2;
+    return c;
+}
+
+/// inserts index into the table, unless an equal name is already present (first name wins)
+/// NOTE: capacity must be a power of two and the table must not be full
+template <bool CaseSensitive, class Entries, class Names>
+constexpr void string_table_insert(Entries& entries, size_t capacity, Names const& names, uint32_t index)
+{
+    auto const h = string_hash<CaseSensitive>(names[index]);
+    auto i = h & (capacity - 1);
+    while (entries[i].index != string_table_entry::empty_index)
+    {
+        if (entries[i].hash == h && string_equals<CaseSensitive>(names[entries[i].index], names[index]))
+            return;
+        i = (i + 1) & (capacity - 1);
+    }
+    entries[i].hash = h;
+    entries[i].index = index;
+}
+
+/// returns the index of s or -1 if not found
+template <bool CaseSensitive, class Entries, class Names>
+constexpr int string_table_find(Entries const& entries, size_t capacity, Names const& names, cc::string_view s)
+{
+    auto const h = string_hash<CaseSensitive>(s);
+    auto i = h & (capacity - 1);
+    while (entries[i].index != string_table_entry::empty_index)
+    {
+        if (entries[i].hash == h && string_equals<CaseSensitive>(names[entries[i].index], s))
+            return int(entries[i].index);
+        i = (i + 1) & (capacity - 1);
+    }
+    return -1;
+}
+
+/// a string table that can be built at compile time
+template <size_t N, bool CaseSensitive>
+struct static_string_table
+{
+    static constexpr size_t capacity = string_table_capacity(N);
+
+    cc::array<string_table_entry, capacity> entries = {};
+    cc::array<cc::string_view, N> names = {};
+
+    /// returns the index of s in names or -1 if not found
+    constexpr int find(cc::string_view s) const { return string_table_find<CaseSensitive>(entries, capacity, names, s); }
+};
+
+template <bool CaseSensitive, size_t N, class Names>
+constexpr static_string_table<N, CaseSensitive> impl_make_static_string_table(Names const& names)
+{
+    static_string_table<N, CaseSensitive> table;
+    // NOTE: explicitly written, as GCC otherwise emits some of the untouched entries zero-initialized
+    for (auto& e : table.entries)
+        e = string_table_entry{};
+    for (size_t i = 0; i < N; ++i)
+        table.names[i] = names[i];
+    for (size_t i = 0; i < N; ++i)
+        string_table_insert<CaseSensitive>(table.entries, table.capacity, table.names, uint32_t(i));
+    return table;
+}
+
+template <bool CaseSensitive, size_t N>
+constexpr static_string_table<N, CaseSensitive> make_static_string_table(cc::array<cc::string_view, N> const& names)
+{
+    return impl_make_static_string_table<CaseSensitive, N>(names);
+}
+
+template <bool CaseSensitive, size_t N>
+constexpr static_string_table<N, CaseSensitive> make_static_string_table(cc::string_view const (&names)[N])
+{
+    return impl_make_static_string_table<CaseSensitive, N>(names);
+}
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <charconv>
+
 #include <clean-core/always_false.hh>
 #include <clean-core/enable_if.hh>
 #include <clean-core/is_range.hh>
@@ -8,21 +10,24 @@
 #include <clean-core/string_view.hh>
 #include <clean-core/to_string.hh>
 
+#include <reflector/enums.hh>
 #include <reflector/introspect.hh>
+#include <reflector/sink.hh>
 
 namespace rf_external_detail
 {
+template <class Sink>
 struct stringifier
 {
-    cc::string& s;
+    Sink& s;
 
     int cnt = 0;
 
-    template <class T>
-    void operator()(T const& v, cc::string_view name);
+    template <class T, class... Args>
+    void operator()(T const& v, cc::string_view name, Args&&...);
 
-    stringifier(cc::string& s) : s(s) { s += "{ "; }
-    ~stringifier() { s += " }"; }
+    stringifier(Sink& s) : s(s) { rf::detail::sink_append(s, "{ "); }
+    ~stringifier() { rf::detail::sink_append(s, " }"); }
 };
 
 template <class T, class = void>
@@ -33,115 +38,130 @@ struct has_to_string_t : std::false_type
 constexpr auto to_string_max_prio = cc::priority_tag<5>();
 
 template <class T>
-auto impl_to_string(T const& value, cc::priority_tag<5>) -> decltype(value.to_string())
+constexpr bool is_to_chars_integer = std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, signed char>
+                                     && !std::is_same_v<T, unsigned char> && !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char16_t>
+                                     && !std::is_same_v<T, char32_t>;
+
+// NOTE: all impl_to_string overloads append to the sink instead of returning a string
+//       so nested members are written in place without temporaries
+
+template <class Sink, class T>
+auto impl_to_string(Sink& sink, T const& value, cc::priority_tag<5>) -> decltype(value.to_string(), void())
 {
-    return value.to_string();
+    rf::detail::sink_append(sink, cc::string_view(value.to_string()));
 }
 
-template <class T>
-auto impl_to_string(T const& value, cc::priority_tag<4>) -> decltype(to_string(value))
+template <class Sink, class T>
+auto impl_to_string(Sink& sink, T const& value, cc::priority_tag<4>) -> decltype(to_string(value), void())
 {
-    return to_string(value);
+    rf::detail::sink_append(sink, cc::string_view(to_string(value)));
 }
 
-template <class T>
-auto impl_to_string(T const& value, cc::priority_tag<3>) -> decltype(cc::to_string(value))
+template <class Sink, class T>
+auto impl_to_string(Sink& sink, T const& value, cc::priority_tag<3>) -> decltype(cc::to_string(value), void())
 {
-    return cc::to_string(value);
+    if constexpr (is_to_chars_integer<T>)
+    {
+        char buffer[24]; // enough for 64 bit integers incl. sign
+        auto const res = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        rf::detail::sink_append(sink, cc::string_view(buffer, res.ptr - buffer));
+    }
+    else if constexpr (std::is_floating_point_v<T>)
+    {
+        // same fixed format as cc::to_string (i.e. printf "%f"), but without a temporary string
+        // NOTE: only huge values (above ~1e120) do not fit into the buffer and fall back to cc::to_string
+        char buffer[128];
+        auto const res = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 6);
+        if (res.ec == std::errc())
+            rf::detail::sink_append(sink, cc::string_view(buffer, res.ptr - buffer));
+        else
+            rf::detail::sink_append(sink, cc::string_view(cc::to_string(value)));
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+        rf::detail::sink_append(sink, value ? "true" : "false");
+    else if constexpr (std::is_same_v<T, char>)
+        rf::detail::sink_append(sink, value);
+    else if constexpr (std::is_convertible_v<T const&, cc::string_view>)
+        rf::detail::sink_append(sink, cc::string_view(value));
+    else
+        rf::detail::sink_append(sink, cc::string_view(cc::to_string(value)));
 }
 
-template <class T, cc::enable_if<std::is_enum_v<T>> = true>
-cc::string impl_to_string(T const& value, cc::priority_tag<2>)
+template <class Sink, class T, cc::enable_if<std::is_enum_v<T>> = true>
+void impl_to_string(Sink& sink, T const& value, cc::priority_tag<2>)
 {
-    cc::string result;
     if constexpr (rf::is_enum_introspectable<T>)
     {
-        auto ok = false;
-        T dummy = {};
-        rf::do_introspect_enum(
-            [&](T&, T ref_value, cc::string_view name)
-            {
-                if (!ok && value == ref_value)
-                {
-                    ok = true;
-                    result = name;
-                }
-            },
-            dummy);
-        if (!ok)
-            result = "<invalid>";
+        rf::detail::sink_append(sink, rf::enum_to_string(value));
     }
     else
     {
         // TODO: replace by demangled name of T
-        result += "enum(";
-        result += cc::to_string(std::underlying_type_t<T>(value));
-        result += ')';
+        rf::detail::sink_append(sink, "enum(");
+        impl_to_string(sink, std::underlying_type_t<T>(value), to_string_max_prio);
+        rf::detail::sink_append(sink, ')');
     }
-    return result;
 }
 
-template <class T, cc::enable_if<rf::is_introspectable<T>> = true>
-cc::string impl_to_string(T const& value, cc::priority_tag<1>)
+template <class Sink, class T, cc::enable_if<rf::is_introspectable<T>> = true>
+void impl_to_string(Sink& sink, T const& value, cc::priority_tag<1>)
 {
-    cc::string str;
-    {
-        auto s = stringifier(str);
-        rf::do_introspect(s, const_cast<T&>(value)); // promise we will not change anything!
-    }
-    return str;
+    auto s = stringifier<Sink>(sink);
+    rf::do_introspect(s, const_cast<T&>(value)); // promise we will not change anything!
 }
 
-template <class T, cc::enable_if<cc::is_any_range<T>> = true>
-cc::string impl_to_string(T const& value, cc::priority_tag<0>)
+template <class Sink, class T, cc::enable_if<cc::is_any_range<T>> = true>
+void impl_to_string(Sink& sink, T const& value, cc::priority_tag<0>)
 {
-    cc::string str;
-    str += '[';
+    rf::detail::sink_append(sink, '[');
     auto first = true;
     for (auto const& v : value)
     {
         if (first)
             first = false;
         else
-        {
-            str += ',';
-            str += ' ';
-        }
+            rf::detail::sink_append(sink, ", ");
+
         if constexpr (has_to_string_t<decltype(v)>::value)
-            str += ::rf_external_detail::impl_to_string(v, to_string_max_prio);
+            ::rf_external_detail::impl_to_string(sink, v, to_string_max_prio);
         else
-            str += "???";
+            rf::detail::sink_append(sink, "???");
     }
-    str += ']';
-    return str;
+    rf::detail::sink_append(sink, ']');
 }
 
 template <class T>
-struct has_to_string_t<T, std::void_t<decltype(::rf_external_detail::impl_to_string(std::declval<T>(), to_string_max_prio))>> : std::true_type
+struct has_to_string_t<T, std::void_t<decltype(::rf_external_detail::impl_to_string(std::declval<cc::string&>(), std::declval<T>(), to_string_max_prio))>>
+  : std::true_type
 {
 };
 
-template <class T>
-void stringifier::operator()(T const& v, cc::string_view name)
+template <class Sink>
+template <class T, class... Args>
+void stringifier<Sink>::operator()(T const& v, cc::string_view name, Args&&...)
 {
-    if (cnt > 0)
-        s += ", ";
+    // transient members are not part of the value (and need not be stringifiable)
+    if constexpr (!rf::detail::is_skipped<rf::transient_t, Args...>)
+    {
+        if (cnt > 0)
+            rf::detail::sink_append(s, ", ");
 
-    s += name;
-    s += ": ";
+        rf::detail::sink_append(s, name);
+        rf::detail::sink_append(s, ": ");
 
-    if constexpr (std::is_convertible_v<T, cc::string>)
-    {
-        s += '"';
-        s += v; // TODO: quote?
-        s += '"';
-    }
-    else
-    {
-        static_assert(has_to_string_t<T>::value, "cannot stringify member");
-        s += ::rf_external_detail::impl_to_string(v, to_string_max_prio);
-    }
+        if constexpr (std::is_convertible_v<T, cc::string>)
+        {
+            rf::detail::sink_append(s, '"');
+            rf::detail::sink_append(s, cc::string_view(v)); // TODO: quote?
+            rf::detail::sink_append(s, '"');
+        }
+        else
+        {
+            static_assert(has_to_string_t<T>::value, "cannot stringify member");
+            ::rf_external_detail::impl_to_string(s, v, to_string_max_prio);
+        }
 
-    ++cnt;
+        ++cnt;
+    }
 }
 }
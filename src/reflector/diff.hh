@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <clean-core/assert.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/compare.hh>
+#include <reflector/detail/serialize.hh>
+#include <reflector/introspect.hh>
+#include <reflector/members.hh>
+#include <reflector/serialize.hh>
+
+namespace rf
+{
+/**
+ * Member-level diff and patch (e.g. for incremental state replication)
+ *
+ * Format of a patch for an introspectable type:
+ *   - changed-member bitmask: one bit per introspected member (bit i = member i in rf::member_infos order), ceil(count / 8) bytes
+ *   - for each changed member in order:
+ *       - introspectable members: their nested patch (recursively)
+ *       - all other members: their new value (see rf::serialize)
+ * Other types are written as a single changed byte (0 or 1), followed by the new value if changed
+ *
+ * Unchanged objects and members are detected via rf::is_equal, so they take the same fast paths
+ * (e.g. a single memcmp for objects whose members tile them without padding)
+ *
+ * Writers provide `void write(void const* data, size_t size)`, `size_t size() const`,
+ *                 and `void write_at(size_t offset, void const* data, size_t size)` (e.g. rf::byte_writer)
+ * Readers provide `bool read(void* data, size_t size)` (e.g. rf::byte_reader)
+ *
+ * NOTE: like rf::serialize, patches are meant for identical builds on both sides
+ *
+ * Usage example:
+ *
+ *   // sender
+ *   rf::byte_writer writer;
+ *   if (rf::diff(writer, last_sent_state, state))
+ *       send(writer.data());
+ *
+ *   // receiver
+ *   auto reader = rf::byte_reader(received);
+ *   if (!rf::apply_patch(reader, state))
+ *       ... // error handling
+ */
+
+namespace detail
+{
+/// small-buffer storage for changed-member masks
+struct diff_mask
+{
+    uint8_t small[32];
+    cc::vector<uint8_t> large;
+    uint8_t* bytes;
+
+    explicit diff_mask(size_t byte_count)
+    {
+        if (byte_count <= sizeof(small))
+            bytes = small;
+        else
+        {
+            large.resize(byte_count);
+            bytes = large.data();
+        }
+        for (size_t i = 0; i < byte_count; ++i)
+            bytes[i] = 0;
+    }
+
+    void set(size_t i) { bytes[i / 8] |= uint8_t(1u << (i % 8)); }
+    bool test(size_t i) const { return (bytes[i / 8] >> (i % 8)) & 1; }
+};
+
+template <class Writer, class T>
+bool impl_diff(Writer& writer, T const& old_value, T const& new_value);
+
+/// members that are not compared or not serialized are not part of patches (their mask bit is always zero)
+template <class... Args>
+constexpr bool is_skipped_by_diff = is_skipped<no_compare_t, Args...> || is_skipped<no_serialize_t, Args...>;
+
+template <class Reader, class T>
+bool impl_apply_patch(Reader& reader, T& value);
+
+/// writes the patch of an introspectable object
+/// NOTE: members are compared individually, callers check the whole object first
+template <class Writer, class T>
+bool impl_diff_members(Writer& writer, T const& old_value, T const& new_value)
+{
+    auto const member_count = rf::get_member_count(new_value);
+    auto const mask_size = (member_count + 7) / 8;
+    auto mask = diff_mask(mask_size);
+
+    auto const mask_pos = writer.size();
+    writer.write(mask.bytes, mask_size);
+
+    auto const old_raw = reinterpret_cast<std::byte const*>(&old_value);
+    auto const new_raw = reinterpret_cast<std::byte const*>(&new_value);
+
+    size_t idx = 0;
+    auto changed = false;
+    rf::do_introspect(
+        [&](auto const& new_m, auto&&... annotations)
+        {
+            using M = std::decay_t<decltype(new_m)>;
+            if constexpr (!is_skipped_by_diff<decltype(annotations)...>)
+            {
+                // members are located via their offset, so they must be subobjects
+                auto const new_m_raw = reinterpret_cast<std::byte const*>(&new_m);
+                CC_ASSERT(size_t(new_m_raw - new_raw) < sizeof(T) && "member is not part of the object");
+                auto const& old_m = *reinterpret_cast<M const*>(old_raw + (new_m_raw - new_raw));
+
+                // unchanged subtrees are skipped after a single (fast path) equality check
+                if (!rf::is_equal(old_m, new_m))
+                {
+                    if constexpr (rf::is_introspectable<M>)
+                        impl_diff_members(writer, old_m, new_m);
+                    else
+                        impl_serialize(writer, new_m);
+
+                    mask.set(idx);
+                    changed = true;
+                }
+            }
+            ++idx;
+        },
+        const_cast<T&>(new_value)); // promise we will not change new_value
+
+    writer.write_at(mask_pos, mask.bytes, mask_size);
+    return changed;
+}
+
+template <class Reader, class T>
+bool impl_apply_patch_members(Reader& reader, T& value)
+{
+    auto const member_count = rf::get_member_count(value);
+    auto const mask_size = (member_count + 7) / 8;
+    auto mask = diff_mask(mask_size);
+    if (!reader.read(mask.bytes, mask_size))
+        return false;
+
+    size_t idx = 0;
+    auto ok = true;
+    rf::do_introspect(
+        [&](auto& m, auto&&... annotations)
+        {
+            using M = std::decay_t<decltype(m)>;
+            if constexpr (!is_skipped_by_diff<decltype(annotations)...>)
+            {
+                if (ok && mask.test(idx))
+                {
+                    if constexpr (rf::is_introspectable<M>)
+                        ok = impl_apply_patch_members(reader, m);
+                    else
+                        ok = impl_deserialize(reader, m);
+                }
+            }
+            else if (mask.test(idx))
+                ok = false; // never written by diff
+            ++idx;
+        },
+        value);
+    return ok;
+}
+
+template <class Writer, class T>
+bool impl_diff(Writer& writer, T const& old_value, T const& new_value)
+{
+    if constexpr (rf::is_introspectable<T>)
+    {
+        // whole object unchanged: all-zero mask
+        if (rf::is_equal(old_value, new_value))
+        {
+            auto const mask_size = (rf::get_member_count(new_value) + 7) / 8;
+            auto const mask = diff_mask(mask_size);
+            writer.write(mask.bytes, mask_size);
+            return false;
+        }
+
+        return impl_diff_members(writer, old_value, new_value);
+    }
+    else
+    {
+        uint8_t const changed = rf::is_equal(old_value, new_value) ? 0 : 1;
+        writer.write(&changed, 1);
+        if (changed)
+            impl_serialize(writer, new_value);
+        return changed;
+    }
+}
+
+template <class Reader, class T>
+bool impl_apply_patch(Reader& reader, T& value)
+{
+    if constexpr (rf::is_introspectable<T>)
+        return impl_apply_patch_members(reader, value);
+    else
+    {
+        uint8_t changed;
+        if (!reader.read(&changed, 1) || changed > 1)
+            return false;
+        return changed == 0 || impl_deserialize(reader, value);
+    }
+}
+}
+
+/// writes the patch that turns old_value into new_value to the writer
+/// returns true iff anything changed (the patch is always written, but an unchanged patch only consists of zero bits)
+template <class Writer, class T>
+bool diff(Writer& writer, T const& old_value, T const& new_value)
+{
+    static_assert(can_serialize<T>, "type cannot be diffed (all changed leaves must be serializable)");
+    return detail::impl_diff(writer, old_value, new_value);
+}
+
+/// returns the patch that turns old_value into new_value
+template <class T>
+[[nodiscard]] byte_writer diff(T const& old_value, T const& new_value)
+{
+    byte_writer writer;
+    rf::diff(writer, old_value, new_value);
+    return writer;
+}
+
+/// applies a patch written by rf::diff to value
+/// returns false if the reader ran out of data or the patch is invalid (value might be partially patched in that case)
+template <class Reader, class T>
+[[nodiscard]] bool apply_patch(Reader& reader, T& value)
+{
+    static_assert(can_serialize<T>, "type cannot be patched (all changed leaves must be serializable)");
+    return detail::impl_apply_patch(reader, value);
+}
+}
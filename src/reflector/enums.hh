@@ -1,11 +1,16 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
 #include <clean-core/array.hh>
+#include <clean-core/assert.hh>
 #include <clean-core/invoke.hh>
 #include <clean-core/string_view.hh>
 
+#include <reflector/detail/string_table.hh>
 #include <reflector/introspect.hh>
 
 namespace rf
@@ -21,26 +26,29 @@ constexpr size_t enum_value_count()
     return cnt;
 }
 
-template <class EnumT>
-constexpr auto enum_values()
+/// all registered values and names, collected in a single introspect_enum pass
+template <class EnumT, size_t N>
+struct enum_descriptor
 {
-    constexpr auto cnt = enum_value_count<EnumT>();
-    auto r = cc::array<EnumT, cnt>();
-    size_t i = 0;
-    EnumT v = {};
-    rf::do_introspect_enum([&r, &i](EnumT&, EnumT val, cc::string_view) { r[i++] = val; }, v);
-    return r;
-}
+    cc::array<EnumT, N> values = {};
+    cc::array<cc::string_view, N> names = {};
+};
 
-template <class EnumT>
-constexpr auto enum_names()
+template <class EnumT, size_t N>
+constexpr enum_descriptor<EnumT, N> make_enum_descriptor()
 {
-    constexpr auto cnt = enum_value_count<EnumT>();
-    auto r = cc::array<cc::string_view, cnt>();
+    enum_descriptor<EnumT, N> d;
     size_t i = 0;
     EnumT v = {};
-    rf::do_introspect_enum([&r, &i](EnumT&, EnumT, cc::string_view name) { r[i++] = name; }, v);
-    return r;
+    rf::do_introspect_enum(
+        [&d, &i](EnumT&, EnumT val, cc::string_view name)
+        {
+            d.values[i] = val;
+            d.names[i] = name;
+            ++i;
+        },
+        v);
+    return d;
 }
 }
 
@@ -48,49 +56,210 @@ constexpr auto enum_names()
 template <class EnumT>
 constexpr size_t enum_value_count = detail::enum_value_count<EnumT>();
 
+namespace detail
+{
+/// computed once per enum and shared by all queries (rf::enum_values, rf::enum_names, and all lookup tables)
+template <class EnumT>
+inline constexpr auto enum_descriptor_of = make_enum_descriptor<EnumT, rf::enum_value_count<EnumT>>();
+}
+
 /// an array containing all registered enum values
 /// NOTE: index does NOT correspond to enum value!
 template <class EnumT>
-constexpr cc::array<EnumT, enum_value_count<EnumT>> enum_values = detail::enum_values<EnumT>();
+constexpr cc::array<EnumT, enum_value_count<EnumT>> const& enum_values = detail::enum_descriptor_of<EnumT>.values;
 
 /// an array containing all registered enum names
 /// NOTE: index does NOT correspond to enum value!
 ///       however, same index in rf::enum_values corresponds to same index in rf::enum_names
 template <class EnumT>
-constexpr cc::array<cc::string_view, enum_value_count<EnumT>> enum_names = detail::enum_names<EnumT>();
+constexpr cc::array<cc::string_view, enum_value_count<EnumT>> const& enum_names = detail::enum_descriptor_of<EnumT>.names;
+
+namespace detail
+{
+// value -> index lookup
+// if the registered values are (nearly) dense, a direct-index table and a validity bitset are used
+// otherwise, a sorted array is binary searched
+
+template <class EnumT>
+using enum_key_t = std::conditional_t<std::is_signed_v<std::underlying_type_t<EnumT>>, int64_t, uint64_t>;
+
+template <class EnumT>
+constexpr enum_key_t<EnumT> enum_key(EnumT v)
+{
+    return enum_key_t<EnumT>(std::underlying_type_t<EnumT>(v));
+}
+
+constexpr uint32_t enum_invalid_index = ~uint32_t(0);
+
+template <class EnumT>
+struct enum_key_range
+{
+    enum_key_t<EnumT> min = 0;
+    uint64_t size = 0; ///< max - min + 1, 0 if there are no values (or the full 64 bit range is used)
+};
+
+template <class EnumT>
+constexpr enum_key_range<EnumT> compute_enum_key_range()
+{
+    enum_key_range<EnumT> r;
+    if constexpr ((rf::enum_value_count<EnumT>) > 0)
+    {
+        auto min = enum_key(rf::enum_values<EnumT>[0]);
+        auto max = min;
+        for (auto v : rf::enum_values<EnumT>)
+        {
+            min = enum_key(v) < min ? enum_key(v) : min;
+            max = enum_key(v) > max ? enum_key(v) : max;
+        }
+        r.min = min;
+        r.size = uint64_t(max) - uint64_t(min) + 1;
+    }
+    return r;
+}
+
+template <class EnumT>
+inline constexpr enum_key_range<EnumT> enum_key_range_of = compute_enum_key_range<EnumT>();
+
+/// dense if a direct-index table wastes at most about half of its slots
+template <class EnumT>
+inline constexpr bool enum_is_dense = enum_key_range_of<EnumT>.size > 0 && enum_key_range_of<EnumT>.size <= 2 * rf::enum_value_count<EnumT> + 64;
+
+/// distance to the smallest registered value (wraps for values below it)
+template <class EnumT>
+constexpr uint64_t enum_dense_offset(EnumT v)
+{
+    return uint64_t(enum_key(v)) - uint64_t(enum_key_range_of<EnumT>.min);
+}
+
+template <class EnumT>
+constexpr auto make_enum_dense_table()
+{
+    cc::array<uint32_t, enum_key_range_of<EnumT>.size> table = {};
+    for (auto& i : table)
+        i = enum_invalid_index;
+    // iterate backwards so that the first registered name wins for duplicate values
+    for (auto i = rf::enum_value_count<EnumT>; i > 0; --i)
+        table[enum_dense_offset(rf::enum_values<EnumT>[i - 1])] = uint32_t(i - 1);
+    return table;
+}
+
+template <class EnumT>
+constexpr auto make_enum_dense_bitset()
+{
+    cc::array<uint64_t, (enum_key_range_of<EnumT>.size + 63) / 64> bits = {};
+    for (auto v : rf::enum_values<EnumT>)
+    {
+        auto const o = enum_dense_offset(v);
+        bits[o / 64] |= uint64_t(1) << (o % 64);
+    }
+    return bits;
+}
+
+template <class EnumT>
+struct enum_sorted_entry
+{
+    enum_key_t<EnumT> key = 0;
+    uint32_t index = 0;
+};
+
+template <class EnumT>
+constexpr auto make_enum_sorted_table()
+{
+    cc::array<enum_sorted_entry<EnumT>, rf::enum_value_count<EnumT>> table = {};
+    size_t cnt = 0;
+    for (size_t i = 0; i < rf::enum_value_count<EnumT>; ++i)
+    {
+        auto const key = enum_key(rf::enum_values<EnumT>[i]);
+
+        // insertion sort, skipping duplicate values (the first registered name wins)
+        auto pos = cnt;
+        while (pos > 0 && table[pos - 1].key > key)
+            --pos;
+        if (pos > 0 && table[pos - 1].key == key)
+            continue;
+
+        for (auto j = cnt; j > pos; --j)
+            table[j] = table[j - 1];
+        table[pos] = {key, uint32_t(i)};
+        ++cnt;
+    }
+
+    // unused tail (only with duplicates) is filled with the largest key to keep the table sorted
+    for (auto i = cnt; i < rf::enum_value_count<EnumT>; ++i)
+        table[i] = table[cnt - 1];
+    return table;
+}
+
+template <class EnumT>
+inline constexpr auto enum_dense_table = make_enum_dense_table<EnumT>();
+
+template <class EnumT>
+inline constexpr auto enum_dense_bitset = make_enum_dense_bitset<EnumT>();
+
+template <class EnumT>
+inline constexpr auto enum_sorted_table = make_enum_sorted_table<EnumT>();
+
+/// returns the index of value in rf::enum_values (the first one if registered multiple times)
+/// or enum_invalid_index if value is not registered
+template <class EnumT>
+constexpr uint32_t enum_index_of(EnumT value)
+{
+    if constexpr (enum_is_dense<EnumT>)
+    {
+        auto const o = enum_dense_offset(value);
+        return o < enum_key_range_of<EnumT>.size ? enum_dense_table<EnumT>[o] : enum_invalid_index;
+    }
+    else
+    {
+        auto const& table = enum_sorted_table<EnumT>;
+        auto const key = enum_key(value);
+
+        size_t lo = 0;
+        size_t hi = table.size();
+        while (lo < hi)
+        {
+            auto const mid = lo + (hi - lo) / 2;
+            if (table[mid].key < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo < table.size() && table[lo].key == key ? table[lo].index : enum_invalid_index;
+    }
+}
+}
 
 /// converts an enum value to its name
 /// (returns def_value if for some reason the value is not registered)
+/// NOTE: if a value is registered multiple times, the first registered name is returned
+///       lookup is O(1) for dense enums and O(log n) otherwise
 template <class EnumT>
 constexpr cc::string_view enum_to_string(EnumT value, cc::string_view def_value = "<invalid>")
 {
-    cc::string_view r = def_value;
-    rf::do_introspect_enum(
-        [value, &r](EnumT&, EnumT val, cc::string_view name) {
-            if (value == val)
-                r = name;
-        },
-        value);
-    return r;
+    auto const idx = detail::enum_index_of(value);
+    return idx == detail::enum_invalid_index ? def_value : rf::enum_names<EnumT>[idx];
+}
+
+namespace detail
+{
+template <class EnumT, bool CaseSensitive>
+inline constexpr auto enum_name_table = detail::make_static_string_table<CaseSensitive>(rf::enum_names<EnumT>);
 }
 
 /// converts a string to an enum value
 /// returns false if the conversion was not succesful, otherwise the result is written to 'value'
 /// NOTE: comparison is case SENSITIVE
+///       lookup is O(1) via a compile time hash table over rf::enum_names
+///       if multiple values are registered with the same name, the first one is used
 template <class EnumT>
 constexpr bool enum_from_string(cc::string_view name, EnumT& value)
 {
-    auto ok = false;
-    rf::do_introspect_enum(
-        [&](EnumT&, EnumT ref_val, cc::string_view ref_name) {
-            if (!ok && ref_name == name)
-            {
-                value = ref_val;
-                ok = true;
-            }
-        },
-        value);
-    return ok;
+    auto const idx = detail::enum_name_table<EnumT, true>.find(name);
+    if (idx < 0)
+        return false;
+
+    value = rf::enum_values<EnumT>[idx];
+    return true;
 }
 
 /// same as bool enum_from_string(name, value)
@@ -104,29 +273,61 @@ constexpr EnumT enum_from_string(cc::string_view name)
     CC_UNREACHABLE_SWITCH_WORKAROUND(val);
 }
 
+/// same as enum_from_string but the comparison is case INSENSITIVE (for ASCII letters)
+template <class EnumT>
+constexpr bool enum_from_string_case_insensitive(cc::string_view name, EnumT& value)
+{
+    auto const idx = detail::enum_name_table<EnumT, false>.find(name);
+    if (idx < 0)
+        return false;
+
+    value = rf::enum_values<EnumT>[idx];
+    return true;
+}
+
+/// same as bool enum_from_string_case_insensitive(name, value)
+/// but returns the value and has undefined behavior if name is not found
+template <class EnumT>
+constexpr EnumT enum_from_string_case_insensitive(cc::string_view name)
+{
+    EnumT val = {};
+    if (enum_from_string_case_insensitive(name, val))
+        return val;
+    CC_UNREACHABLE_SWITCH_WORKAROUND(val);
+}
+
 /// returns true if the given enum value was registered
 template <class EnumT>
 constexpr bool is_enum_value_valid(EnumT value)
 {
-    for (EnumT v : rf::enum_values<EnumT>)
-        if (v == value)
-            return true;
-    return false;
+    if constexpr (detail::enum_is_dense<EnumT>)
+    {
+        auto const o = detail::enum_dense_offset(value);
+        return o < detail::enum_key_range_of<EnumT>.size && (detail::enum_dense_bitset<EnumT>[o / 64] >> (o % 64)) & 1;
+    }
+    else
+        return detail::enum_index_of(value) != detail::enum_invalid_index;
 }
 
 namespace detail
 {
-template <int I, class Fun, class EnumT, class... Args>
-constexpr decltype(auto) enum_invoke(EnumT val, Fun&& fun, Args&&... args)
+template <class EnumT, size_t I, class Fun, class... Args>
+constexpr decltype(auto) enum_invoke_at(Fun& fun, Args&&... args)
 {
-    constexpr EnumT v = rf::enum_values<EnumT>[I];
-    if (v == val)
-        return cc::invoke(fun, std::integral_constant<EnumT, v>(), cc::forward<Args>(args)...);
-    else if constexpr (I < rf::enum_value_count<EnumT> - 1)
-        return detail::enum_invoke<I + 1>(val, fun, cc::forward<Args>(args)...);
+    return cc::invoke(fun, std::integral_constant<EnumT, rf::enum_values<EnumT>[I]>(), cc::forward<Args>(args)...);
+}
 
-    CC_UNREACHABLE("unknown enum value (did you forget to add it to introspect_enum?)");
+template <class EnumT, class Fun, class... Args, size_t... I>
+constexpr auto make_enum_invoke_table(std::index_sequence<I...>)
+{
+    using result_t = decltype(detail::enum_invoke_at<EnumT, 0>(std::declval<Fun&>(), std::declval<Args>()...));
+    using fun_ptr_t = result_t (*)(Fun&, Args&&...);
+    return cc::array<fun_ptr_t, sizeof...(I)>{{&detail::enum_invoke_at<EnumT, I, Fun, Args...>...}};
 }
+
+/// one function pointer per entry of rf::enum_values
+template <class EnumT, class Fun, class... Args>
+inline constexpr auto enum_invoke_table = make_enum_invoke_table<EnumT, Fun, Args...>(std::make_index_sequence<rf::enum_value_count<EnumT>>());
 }
 
 /// takes a runtime enum value and invokes 'fun' with a compile time value for it
@@ -135,6 +336,7 @@ constexpr decltype(auto) enum_invoke(EnumT val, Fun&& fun, Args&&... args)
 /// all other arguments are simply forwarded 'args'
 /// NOTE: currently, all 'fun' instantiations need to return the same type
 ///       value must be registered, otherwise this triggers UB (an assertion)
+///       dispatch is a table lookup (see enum_to_string) and a single indirect call
 ///
 /// Usage:
 ///
@@ -149,6 +351,12 @@ constexpr decltype(auto) enum_invoke(EnumT val, Fun&& fun, Args&&... args)
 {
     static_assert(rf::is_enum_introspectable<EnumT>, "enum must be introspectable");
     static_assert((rf::enum_value_count<EnumT>) > 0, "enum must have at least one value");
-    return detail::enum_invoke<0>(val, fun, cc::forward<Args>(args)...);
+
+    auto const idx = detail::enum_index_of(val);
+    if (idx == detail::enum_invalid_index)
+        CC_UNREACHABLE("unknown enum value (did you forget to add it to introspect_enum?)");
+
+    using fun_t = std::remove_reference_t<Fun>;
+    return detail::enum_invoke_table<EnumT, fun_t, Args...>[idx](fun, cc::forward<Args>(args)...);
 }
 }
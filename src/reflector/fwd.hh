@@ -0,0 +1,7 @@
+#pragma once
+
+namespace rf
+{
+template <class T>
+class hashed;
+}
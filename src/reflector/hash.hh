@@ -7,6 +7,9 @@
 namespace rf
 {
 /// general-purpose reflection-based hashing
+/// NOTE: at runtime, bytewise hashable types and member runs are hashed via their object representation
+///       in constant expressions they are hashed memberwise instead, which yields different hash values
+///       (so compile-time and runtime hashes of such types must not be compared)
 struct hash
 {
     template <class T>
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include <reflector/compare.hh>
+#include <reflector/fwd.hh>
+#include <reflector/hash.hh>
+
+namespace rf
+{
+/**
+ * A value with a memoized reflection hash
+ *
+ * The hash is computed on first use and cached until the value is accessed mutably via write() (or assigned)
+ * rf::hash treats hashed<T> as transparent: rf::hash{}(hashed<T>(v)) == rf::hash{}(v)
+ * so hashed<T> members of larger objects contribute their cached hash instead of being re-walked
+ * (re-hashing after a small edit is then proportional to the edited subobjects)
+ *
+ * NOTE: the reference returned by write() must not be used after the next call to hash()
+ *       (changes made through it afterwards are not tracked)
+ *       computing the hash mutates the cache, so concurrent const access requires external synchronization
+ *
+ * Usage example:
+ *
+ *   struct asset
+ *   {
+ *       rf::hashed<mesh_data> mesh;
+ *       rf::hashed<material_data> material;
+ *   };
+ *
+ *   a.material.write().roughness = 0.5f;
+ *   auto h = rf::make_hash(a); // only re-hashes the material
+ */
+template <class T>
+class hashed
+{
+public:
+    hashed() = default;
+    hashed(T const& value) : _value(value) {}
+    hashed(T&& value) : _value(std::move(value)) {}
+
+    hashed& operator=(T const& value)
+    {
+        _value = value;
+        _is_hash_valid = false;
+        return *this;
+    }
+    hashed& operator=(T&& value)
+    {
+        _value = std::move(value);
+        _is_hash_valid = false;
+        return *this;
+    }
+
+    /// read-only access (does not invalidate the hash)
+    [[nodiscard]] T const& get() const { return _value; }
+    [[nodiscard]] T const& operator*() const { return _value; }
+    [[nodiscard]] T const* operator->() const { return &_value; }
+    operator T const&() const { return _value; }
+
+    /// mutable access, invalidates the cached hash
+    [[nodiscard]] T& write()
+    {
+        _is_hash_valid = false;
+        return _value;
+    }
+
+    /// returns rf::hash{}(get()), computed at most once per modification
+    [[nodiscard]] uint64_t hash() const
+    {
+        if (!_is_hash_valid)
+        {
+            _hash = rf::hash{}(_value);
+            _is_hash_valid = true;
+        }
+        return _hash;
+    }
+
+    [[nodiscard]] bool is_hash_cached() const { return _is_hash_valid; }
+
+    /// different cached hashes reject without comparing the values
+    [[nodiscard]] friend bool operator==(hashed const& lhs, hashed const& rhs)
+    {
+        if (lhs._is_hash_valid && rhs._is_hash_valid && lhs._hash != rhs._hash)
+            return false;
+        return rf::is_equal(lhs._value, rhs._value);
+    }
+    [[nodiscard]] friend bool operator!=(hashed const& lhs, hashed const& rhs) { return !(lhs == rhs); }
+
+private:
+    T _value = {};
+    mutable uint64_t _hash = 0;
+    mutable bool _is_hash_valid = false;
+};
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <reflector/annotations.hh>
 #include <reflector/detail/is_introspectable.hh>
 
 namespace rf
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <clean-core/string.hh>
+#include <clean-core/string_view.hh>
+
+#include <reflector/detail/json_reader.hh>
+#include <reflector/detail/json_writer.hh>
+
+namespace rf
+{
+/**
+ * Introspection-based JSON output
+ *
+ * Mapping:
+ *   - bool: true / false
+ *   - integers and floating point: numbers (shortest round-trip representation, inf and nan are written as null)
+ *   - char and types convertible to cc::string_view: escaped strings
+ *   - introspectable enums: their name as string (unregistered values are written as their underlying integer)
+ *   - other enums: their underlying integer
+ *   - introspectable types: objects with their introspected members in order
+ *   - ranges: arrays
+ *   - everything else with a to_string (see rf::to_string): its string representation as escaped string
+ *
+ * Output is written directly into a sink (see reflector/sink.hh), without intermediate strings or per-value allocations
+ *
+ * Usage example:
+ *
+ *   cc::string s;
+ *   rf::write_json(s, my_value);
+ *
+ *   char buffer[1024];
+ *   auto sink = rf::buffer_sink(buffer);
+ *   rf::write_json(sink, my_value);
+ */
+
+/// true iff T can be written as JSON
+template <class T>
+static constexpr bool can_write_json = detail::can_write_json_t<T>::value;
+
+/// appends the compact JSON representation of value to the sink
+template <class Sink, class T>
+void write_json(Sink& sink, T const& value)
+{
+    static_assert(can_write_json<T>, "type cannot be written as JSON");
+    detail::impl_write_json(sink, value);
+}
+
+/// returns the compact JSON representation of value
+template <class T>
+cc::string to_json(T const& value)
+{
+    cc::string s;
+    rf::write_json(s, value);
+    return s;
+}
+
+/**
+ * Introspection-based JSON input (the inverse of rf::write_json)
+ *
+ *   - object keys are matched against member names via a hash table
+ *     (built at compile time if the type can be introspected in a constant expression, otherwise once per type)
+ *   - unknown keys are skipped (without allocating), missing members keep their previous value
+ *   - resizable ranges (e.g. cc::vector) are resized to the array size, fixed-size ranges must match exactly
+ *   - enums are read from their name or underlying integer, floating point values from numbers or null (as nan)
+ *   - the text is parsed in place: cc::string_view members reference it directly (and fail on escaped strings)
+ *
+ * Usage example:
+ *
+ *   my_config cfg;
+ *   if (!rf::read_json(file_content, cfg))
+ *       ... // error handling
+ */
+
+/// true iff T can be read from JSON
+template <class T>
+static constexpr bool can_read_json = detail::can_read_json_t<T>::value;
+
+/// parses the JSON text into value
+/// returns false if the text is not valid JSON or does not match the structure of T
+/// (value might be partially overwritten in that case)
+template <class T>
+[[nodiscard]] bool read_json(cc::string_view text, T& value)
+{
+    static_assert(can_read_json<T>, "type cannot be read from JSON");
+
+    auto reader = detail::json_reader{text.data(), text.data() + text.size()};
+    if (!detail::impl_read_json(reader, value))
+        return false;
+
+    reader.skip_ws();
+    return reader.cur == reader.end;
+}
+}
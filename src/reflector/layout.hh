@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+
+#include <clean-core/assert.hh>
+#include <clean-core/string.hh>
+#include <clean-core/string_view.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/introspect.hh>
+#include <reflector/members.hh>
+#include <reflector/sink.hh>
+
+namespace rf
+{
+/**
+ * Memory layout analysis of introspectable types (padding holes, cache line straddling, reorder suggestions)
+ *
+ * rf::layout_summary_of<T> is available at compile time (sizes and alignments of the members are compile time properties)
+ * rf::layout_report<T> additionally needs the member offsets and is thus computed at runtime (once per type)
+ *
+ * NOTE: all bytes of T that are not covered by introspected members count as padding
+ *       (i.e. non-introspected members, base classes, and vtable pointers are reported as padding as well)
+ *       the reordered size is a best-effort estimate: members sorted by decreasing alignment have no holes,
+ *       so it is the sum of the member sizes rounded up to alignof(T)
+ *       layout_summary_of<T> has the same requirements as rf::member_count<T> (constexpr default construction)
+ *
+ * Usage example:
+ *
+ *   REFL_ASSERT_NO_PADDING(particle); // compile error if particle has holes or tail padding
+ *
+ *   cc::string s;
+ *   rf::write_layout_report(s, rf::layout_report<transform_component>);
+ *   LOG("{}", s);
+ */
+
+struct layout_summary
+{
+    size_t size = 0;
+    size_t alignment = 0;
+    size_t member_count = 0;
+    size_t member_size_sum = 0;
+    size_t padding = 0;        ///< bytes of T not covered by members (holes and tail padding)
+    size_t reordered_size = 0; ///< size of T if the members were sorted by decreasing alignment
+
+    [[nodiscard]] constexpr bool has_padding() const { return padding > 0; }
+    [[nodiscard]] constexpr size_t reorder_savings() const { return size - reordered_size; }
+};
+
+/// a range of padding bytes
+struct layout_hole
+{
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+/// a member in a layout report
+struct layout_member
+{
+    cc::string_view name;
+    size_t offset = 0; ///< byte offset relative to the start of the object
+    size_t size = 0;
+    size_t alignment = 0;
+};
+
+struct layout_report_t
+{
+    layout_summary summary;
+    size_t cache_line_size = 64;
+    cc::vector<layout_member> members;     ///< in introspect order
+    cc::vector<layout_hole> holes;         ///< in offset order, including tail padding
+    cc::vector<size_t> straddling_members; ///< indices of members that cross a cache line boundary although they would fit into a single line
+    cc::vector<size_t> suggested_order;    ///< member indices sorted by decreasing alignment (stable)
+};
+
+/// computes the layout report of T (member offsets are taken from rf::member_offsets<T>)
+/// NOTE: cache lines are relative to the start of the object (i.e. assume objects that start at a cache line boundary)
+///       all introspected members must be subobjects
+template <class T>
+layout_report_t get_layout_report(size_t cache_line_size = 64);
+
+namespace detail
+{
+template <class T>
+constexpr layout_summary make_layout_summary();
+}
+
+/// compile time layout summary of T
+template <class T>
+inline constexpr layout_summary layout_summary_of = detail::make_layout_summary<T>();
+
+/// layout report of T, computed once per type (from a default-constructed T)
+/// NOTE: this is dynamically initialized, so don't use it during static initialization
+template <class T>
+inline layout_report_t const layout_report = get_layout_report<T>();
+
+/// appends a human-readable table of the layout (members, holes, straddling members, and the suggested order) to the sink
+template <class Sink>
+void write_layout_report(Sink& sink, layout_report_t const& report);
+
+/// compile-time check that the introspected members of Type cover all of its bytes
+#define REFL_ASSERT_NO_PADDING(Type) \
+    static_assert(::rf::layout_summary_of<Type>.padding == 0, #Type " has padding (see rf::layout_report for the holes)")
+
+
+// ==================================================
+// implementation details:
+
+namespace detail
+{
+constexpr size_t layout_align_up(size_t v, size_t alignment) { return (v + alignment - 1) / alignment * alignment; }
+
+constexpr layout_summary compute_layout_summary(size_t size, size_t alignment, size_t member_count, size_t member_size_sum)
+{
+    layout_summary s;
+    s.size = size;
+    s.alignment = alignment;
+    s.member_count = member_count;
+    s.member_size_sum = member_size_sum;
+    // NOTE: guarded against introspect functions that list non-subobjects
+    s.padding = member_size_sum < size ? size - member_size_sum : 0;
+    s.reordered_size = std::min(size, layout_align_up(member_size_sum, alignment));
+    return s;
+}
+
+template <class T>
+constexpr layout_summary make_layout_summary()
+{
+    static_assert(rf::is_introspectable<T>, "type must be introspectable");
+    auto const& info = static_type_info_of<T>;
+    return compute_layout_summary(sizeof(T), alignof(T), info.member_count, info.member_size_sum);
+}
+
+struct LayoutMemberBuilder
+{
+    cc::vector<layout_member>& members;
+    template <class M, class... Args>
+    void operator()(M&, cc::string_view name, Args&&...)
+    {
+        members.push_back({name, 0, sizeof(M), alignof(M)});
+    }
+};
+
+template <class Sink>
+void layout_append_number(Sink& sink, size_t v, size_t width)
+{
+    char buffer[24];
+    auto const res = std::to_chars(buffer, buffer + sizeof(buffer), v);
+    for (auto n = size_t(res.ptr - buffer); n < width; ++n)
+        sink_append(sink, ' ');
+    sink_append(sink, cc::string_view(buffer, res.ptr - buffer));
+}
+}
+
+template <class T>
+layout_report_t get_layout_report(size_t cache_line_size)
+{
+    static_assert(rf::is_introspectable<T>, "type must be introspectable");
+    CC_ASSERT(cache_line_size > 0);
+
+    auto const& offsets = rf::member_offsets<T>();
+    CC_ASSERT(offsets.is_valid && "all introspected members must be subobjects");
+
+    layout_report_t r;
+    r.cache_line_size = cache_line_size;
+
+    // NOTE: built at runtime, so that types that are not constexpr-constructible work as well
+    T t = {};
+    rf::do_introspect(detail::LayoutMemberBuilder{r.members}, t);
+    for (size_t i = 0; i < r.members.size(); ++i)
+        r.members[i].offset = offsets[i];
+
+    size_t size_sum = 0;
+    for (size_t i = 0; i < r.members.size(); ++i)
+    {
+        auto const& m = r.members[i];
+        size_sum += m.size;
+
+        if (m.size > 0 && m.size <= cache_line_size && m.offset / cache_line_size != (m.offset + m.size - 1) / cache_line_size)
+            r.straddling_members.push_back(i);
+
+        r.suggested_order.push_back(i);
+    }
+    r.summary = detail::compute_layout_summary(sizeof(T), alignof(T), r.members.size(), size_sum);
+
+    std::stable_sort(r.suggested_order.begin(), r.suggested_order.end(),
+                     [&](size_t a, size_t b) { return r.members[a].alignment > r.members[b].alignment; });
+
+    // holes: gaps between the members in offset order and the tail padding
+    auto by_offset = r.suggested_order; // any permutation of the indices
+    std::sort(by_offset.begin(), by_offset.end(), [&](size_t a, size_t b) { return r.members[a].offset < r.members[b].offset; });
+    size_t end = 0;
+    for (auto i : by_offset)
+    {
+        auto const& m = r.members[i];
+        if (m.offset > end)
+            r.holes.push_back({end, m.offset - end});
+        end = std::max(end, m.offset + m.size);
+    }
+    if (end < sizeof(T))
+        r.holes.push_back({end, sizeof(T) - end});
+
+    return r;
+}
+
+template <class Sink>
+void write_layout_report(Sink& sink, layout_report_t const& report)
+{
+    using detail::layout_append_number;
+    using detail::sink_append;
+
+    auto const& s = report.summary;
+    sink_append(sink, "size ");
+    layout_append_number(sink, s.size, 0);
+    sink_append(sink, ", alignment ");
+    layout_append_number(sink, s.alignment, 0);
+    sink_append(sink, ", ");
+    layout_append_number(sink, s.member_count, 0);
+    sink_append(sink, " members (");
+    layout_append_number(sink, s.member_size_sum, 0);
+    sink_append(sink, " bytes), padding ");
+    layout_append_number(sink, s.padding, 0);
+    sink_append(sink, " bytes\n");
+
+    // members and holes in offset order
+    sink_append(sink, "  offset    size   align  member\n");
+    auto by_offset = report.suggested_order;
+    std::sort(by_offset.begin(), by_offset.end(), [&](size_t a, size_t b) { return report.members[a].offset < report.members[b].offset; });
+    size_t hole_idx = 0;
+    auto const append_holes_before = [&](size_t offset)
+    {
+        for (; hole_idx < report.holes.size() && report.holes[hole_idx].offset < offset; ++hole_idx)
+        {
+            auto const& h = report.holes[hole_idx];
+            layout_append_number(sink, h.offset, 8);
+            layout_append_number(sink, h.size, 8);
+            sink_append(sink, h.offset + h.size == s.size ? "          <tail padding>\n" : "          <padding>\n");
+        }
+    };
+    for (auto i : by_offset)
+    {
+        auto const& m = report.members[i];
+        append_holes_before(m.offset);
+        layout_append_number(sink, m.offset, 8);
+        layout_append_number(sink, m.size, 8);
+        layout_append_number(sink, m.alignment, 8);
+        sink_append(sink, "  ");
+        sink_append(sink, m.name);
+        if (std::find(report.straddling_members.begin(), report.straddling_members.end(), i) != report.straddling_members.end())
+            sink_append(sink, "  (straddles a cache line)");
+        sink_append(sink, '\n');
+    }
+    append_holes_before(s.size + 1);
+
+    if (s.reorder_savings() > 0)
+    {
+        sink_append(sink, "reordering by decreasing alignment: size ");
+        layout_append_number(sink, s.size, 0);
+        sink_append(sink, " -> ");
+        layout_append_number(sink, s.reordered_size, 0);
+        sink_append(sink, " (");
+        for (size_t k = 0; k < report.suggested_order.size(); ++k)
+        {
+            if (k > 0)
+                sink_append(sink, ", ");
+            sink_append(sink, report.members[report.suggested_order[k]].name);
+        }
+        sink_append(sink, ")\n");
+    }
+}
+}
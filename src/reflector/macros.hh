@@ -1,6 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <cstring>
+
 #include <clean-core/macros.hh>
+#include <clean-core/string_view.hh>
+
+#include <reflector/detail/string_table.hh>
 
 /**
  * create an introspection function with a little less boilerplate
@@ -67,6 +73,9 @@
  * // declare a to-string function
  * REFL_DECLARE_TOSTRING(to_string, CommandTypes, COMMAND_LIST);
  *
+ * // declare from-string functions (null-terminated and sized)
+ * REFL_DECLARE_FROMSTRING(from_string, CommandTypes, COMMAND_LIST);
+ *
  * // use it in a manual context
  * enum class e_cmd_types : uint8_t
  * {
@@ -99,14 +108,21 @@
         return true;                    \
     }
 
-/// X Macro functor for an if-chain that compares a sized string to all literals
-#define REFL_X_FROMSTRING_IF_N(Val, ...)      \
-    if (std::strncmp(str, #Val, strlen) == 0) \
-    {                                         \
-        out_value = rf_xlist_enum::Val;       \
-        return true;                          \
+/// X Macro functor for an if-chain that compares a sized string to all literals (expects 'char const* str' and 'size_t strlen')
+/// NOTE: REFL_DECLARE_FROMSTRING is faster for all but the shortest lists
+#define REFL_X_FROMSTRING_IF_N(Val, ...)                                             \
+    if (strlen == sizeof(#Val) - 1 && std::memcmp(str, #Val, sizeof(#Val) - 1) == 0) \
+    {                                                                                \
+        out_value = rf_xlist_enum::Val;                                              \
+        return true;                                                                 \
     }
 
+/// X Macro functor for an array of all names (as cc::string_view)
+#define REFL_X_NAME(Val, ...) ::cc::string_view(#Val, sizeof(#Val) - 1),
+
+/// X Macro functor for an array of all values (requires 'using rf_xlist_enum = Type;')
+#define REFL_X_VALUE(Val, ...) rf_xlist_enum::Val,
+
 /// Declares an enum class from a list
 #define REFL_DECLARE_ENUM_CLASS(Type, List) \
     enum class Type                         \
@@ -136,15 +152,25 @@
     }
 // clang-format on
 
-/// Declares a from-string function, requires <cstring>
+/// Declares from-string functions: FuncName(char const* str, Type& out) and FuncName(char const* str, size_t length, Type& out)
+/// (the latter does not require str to be null-terminated)
+/// the names are looked up in a hash table that is built at compile time, so a lookup costs a hash of str and (usually) one compare
+/// NOTE: if a name appears multiple times in the list, the first one wins
 // clang-format off
-#define REFL_DECLARE_FROMSTRING(FuncName, Type, List)                       \
-    [[maybe_unused]] inline bool FuncName(char const* str, Type& out_value) \
-    {                                                                       \
-        using rf_xlist_enum = Type;                                         \
-        List(REFL_X_FROMSTRING_IF)                                          \
-        return false;                                                       \
-    }
+#define REFL_DECLARE_FROMSTRING(FuncName, Type, List)                                                              \
+    [[maybe_unused]] inline bool FuncName(char const* str, size_t length, Type& out_value)                         \
+    {                                                                                                              \
+        using rf_xlist_enum = Type;                                                                                \
+        static constexpr Type rf_xlist_values[] = {List(REFL_X_VALUE)};                                            \
+        static constexpr ::cc::string_view rf_xlist_names[] = {List(REFL_X_NAME)};                                 \
+        static constexpr auto rf_xlist_table = ::rf::detail::make_static_string_table<true>(rf_xlist_names);       \
+        auto const idx = rf_xlist_table.find(::cc::string_view(str, length));                                      \
+        if (idx < 0)                                                                                               \
+            return false;                                                                                          \
+        out_value = rf_xlist_values[idx];                                                                          \
+        return true;                                                                                               \
+    }                                                                                                              \
+    [[maybe_unused]] inline bool FuncName(char const* str, Type& out_value) { return FuncName(str, std::strlen(str), out_value); }
 // clang-format on
 
 
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstddef>
+#include <type_traits>
+
 #include <clean-core/array.hh>
 #include <clean-core/string_view.hh>
+#include <clean-core/vector.hh>
 
+#include <reflector/detail/string_table.hh>
 #include <reflector/introspect.hh>
 
 namespace rf
@@ -10,33 +15,115 @@ namespace rf
 struct member_info
 {
     cc::string_view name;
-    size_t offset = 0;
+    size_t size = 0;      ///< sizeof(member)
+    size_t alignment = 0; ///< alignof(member)
+    bool is_trivially_copyable = false;
 };
 
 struct class_info_t
 {
 };
 
+/// byte offsets of the introspected members of a type relative to the start of the object (in introspect order)
+/// NOTE: offsets are not part of rf::member_info, as they cannot be computed in a constant expression
+struct member_offset_table
+{
+    cc::vector<size_t> offsets;
+    bool is_valid = true; ///< false if some introspected member is not a subobject (the offsets are meaningless then)
+
+    [[nodiscard]] size_t size() const { return offsets.size(); }
+    [[nodiscard]] size_t operator[](size_t i) const { return offsets[i]; }
+};
+
 // ==================================================
 // runtime/hybrid information: (dynamic reflection)
 
 template <class T>
 constexpr size_t get_member_count(T const& t = {});
 
+/// computes the member infos of t (name, size, alignment, and is_trivially_copyable of each member)
 template <class T>
 constexpr auto get_member_infos(T const& t = {});
 
+/// computes the byte offsets of the members of t relative to t
+/// NOTE: offsets are computed from the member addresses and thus this function is not constexpr
+///       unlike get_member_infos, this also works for types that are not literal types
+template <class T>
+member_offset_table get_member_offsets(T const& t = {});
+
 
 // ==================================================
 // compile time information: (static reflection)
 
+namespace detail
+{
+/// compile-time properties of T, computed in a single introspect pass once per type
+/// and shared by all queries (rf::member_count, the layout checks of the bytewise fast paths, ...)
+struct static_type_info
+{
+    size_t member_count = 0;
+    size_t member_size_sum = 0; ///< sum of all member sizes (== sizeof(T) iff the members tile T without padding)
+};
+
 template <class T>
-static constexpr size_t member_count = get_member_count<T>();
+constexpr static_type_info make_static_type_info();
+
+template <class T>
+inline constexpr static_type_info static_type_info_of = make_static_type_info<T>();
+
+template <class T, size_t = make_static_type_info<T>().member_count>
+constexpr bool check_constexpr_introspectable(int)
+{
+    return true;
+}
+template <class T>
+constexpr bool check_constexpr_introspectable(...)
+{
+    return false;
+}
+
+/// true iff introspect on a default-constructed T can be evaluated in a constant expression
+/// (i.e. introspect is constexpr and T is constexpr default-constructible)
+/// NOTE: SFINAE-based, so this is false instead of a hard error for types with a non-constexpr introspect
+///       only use this for introspectable T
+template <class T>
+inline constexpr bool is_constexpr_introspectable = check_constexpr_introspectable<T>(0);
+
+template <class T>
+constexpr bool compute_has_member_name_table();
+
+/// true iff T has at least one member and member_name_table<T> is available
+/// (i.e. T is default constructible and can be introspected in a constant expression)
+/// only use this for introspectable T
+template <class T>
+inline constexpr bool has_member_name_table = compute_has_member_name_table<T>();
+
+template <class T>
+constexpr auto make_member_name_table();
+
+/// compile-time hash table from member names to member indices (in introspect order, first name wins)
+/// used for name-based member lookups (json reader, rf::visit_member), offsets are taken from rf::member_offsets
+template <class T>
+inline constexpr auto member_name_table = make_member_name_table<T>();
+}
+
+template <class T>
+static constexpr size_t member_count = detail::static_type_info_of<T>.member_count;
 
 template <class T>
 inline constexpr auto member_infos = get_member_infos<T>();
 
 
+// ==================================================
+// cached information:
+
+/// member offsets of T, computed once per type (from a value-initialized T)
+/// this is the single source of member offsets for all offset-based operations (json reader, rf::visit_member, rf::soa_vector, ...)
+/// NOTE: cached in a function-local static, so this can also be used during static initialization
+template <class T>
+member_offset_table const& member_offsets();
+
+
 // ==================================================
 // implementation details:
 
@@ -52,19 +139,79 @@ struct MemberCounter
     }
 };
 
+struct StaticTypeInfoBuilder
+{
+    static_type_info& info;
+    template <class T, class... Args>
+    constexpr void operator()(T&, Args&&...)
+    {
+        ++info.member_count;
+        info.member_size_sum += sizeof(T);
+    }
+};
+
 struct MemberInfoBuilder
 {
     member_info* members;
-    size_t struct_start;
-    size_t struct_size;
     template <class T, class... Args>
     constexpr void operator()(T&, cc::string_view name, Args&&...)
     {
         members->name = name;
-        members->offset = 0;
+        members->size = sizeof(T);
+        members->alignment = alignof(T);
+        members->is_trivially_copyable = std::is_trivially_copyable_v<T>;
         ++members;
     }
 };
+
+struct MemberOffsetBuilder
+{
+    member_offset_table& table;
+    std::byte const* struct_start;
+    size_t struct_size;
+    template <class T, class... Args>
+    void operator()(T& v, Args&&...)
+    {
+        auto const member_start = reinterpret_cast<std::byte const*>(&v);
+        if (member_start < struct_start || member_start + sizeof(T) > struct_start + struct_size)
+            table.is_valid = false;
+        table.offsets.push_back(size_t(member_start - struct_start));
+    }
+};
+
+template <class T>
+constexpr static_type_info make_static_type_info()
+{
+    static_type_info info;
+    T t = {};
+    rf::do_introspect(StaticTypeInfoBuilder{info}, t);
+    return info;
+}
+
+template <class T>
+constexpr bool compute_has_member_name_table()
+{
+    // NOTE: nested so that the constexpr check is only instantiated for default constructible types
+    if constexpr (std::is_default_constructible_v<T>)
+    {
+        if constexpr (is_constexpr_introspectable<T>)
+            return member_count<T> > 0;
+        else
+            return false;
+    }
+    else
+        return false;
+}
+
+template <class T>
+constexpr auto make_member_name_table()
+{
+    constexpr auto count = member_count<T>;
+    cc::array<cc::string_view, count> names = {};
+    for (size_t i = 0; i < count; ++i)
+        names[i] = member_infos<T>[i].name;
+    return make_static_string_table<true>(names);
+}
 }
 
 template <class T>
@@ -81,9 +228,26 @@ constexpr auto get_member_infos(T const& t)
     auto constexpr cnt = member_count<T>;
     cc::array<member_info, cnt> members = {};
 
-    auto builder = detail::MemberInfoBuilder{members.data(), 0, 0};
+    auto builder = detail::MemberInfoBuilder{members.data()};
     rf::do_introspect(builder, const_cast<T&>(t));
 
     return members;
 }
+
+template <class T>
+member_offset_table get_member_offsets(T const& t)
+{
+    member_offset_table table;
+    auto builder = detail::MemberOffsetBuilder{table, reinterpret_cast<std::byte const*>(&t), sizeof(T)};
+    rf::do_introspect(builder, const_cast<T&>(t)); // promise we will not change t
+    return table;
+}
+
+template <class T>
+member_offset_table const& member_offsets()
+{
+    static_assert(std::is_default_constructible_v<T>, "member offsets are computed from a value-initialized T");
+    static auto const table = get_member_offsets(T{});
+    return table;
+}
 }
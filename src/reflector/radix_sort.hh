@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+
+#include <clean-core/assert.hh>
+
+#include <reflector/detail/radix_sort.hh>
+#include <reflector/detail/range_traits.hh>
+
+namespace rf
+{
+/**
+ * Stable radix sort for contiguous ranges of arithmetic values, enums, and introspectable types
+ *
+ * The sort key is derived from the value (rf::radix_sort) or from selected members (rf::radix_sort_by):
+ *   - unsigned integers (up to 64 bit) and bool: as is
+ *   - signed integers: sign bit flipped
+ *   - float and double: IEEE bits transformed such that negative values sort before positive ones
+ *   - enums: their underlying integer
+ *   - introspectable types: their members in introspection order (i.e. lexicographic, like rf::compare)
+ *
+ * Short keys (up to 4 bytes) are sorted by LSD passes, longer (composite) keys by MSD partitioning
+ * that only processes the bytes needed to distinguish elements
+ * Runtime is at most O(n * key bytes), bytes that all keys share are skipped
+ * (e.g. the high bytes of small integers or constant members)
+ *
+ * NOTE: unlike rf::compare, -0.0 sorts before 0.0 and NaNs sort by their bits (positive NaNs after +inf)
+ *       requires O(n * (key bytes + 4)) temporary memory and at most 2^32 elements
+ *
+ * Usage example:
+ *
+ *   rf::radix_sort(records);                                      // by all members
+ *   rf::radix_sort_by(draw_calls, &draw_call::layer, &draw_call::depth);
+ *   rf::radix_sort(records, rf::radix_sort_mode::parallel);       // uses all hardware threads for large inputs
+ */
+
+enum class radix_sort_mode
+{
+    sequential,
+    parallel
+};
+
+namespace detail
+{
+/// below this size, parallel mode is not worth the thread overhead
+constexpr size_t radix_parallel_min_size = 1 << 16;
+
+inline size_t radix_thread_count(radix_sort_mode mode, size_t count)
+{
+    if (mode == radix_sort_mode::sequential || count < radix_parallel_min_size)
+        return 1;
+    auto const hw = size_t(std::thread::hardware_concurrency());
+    return hw > 1 ? hw : 1;
+}
+}
+
+/// sorts the contiguous range values by all of its members (or its value for arithmetic types and enums)
+template <class Range>
+void radix_sort(Range& values, radix_sort_mode mode = radix_sort_mode::sequential)
+{
+    static_assert(detail::is_contiguous_range_t<Range>::value, "values must be a contiguous range");
+    using T = detail::range_element_t<Range>;
+
+    auto const data = std::data(values);
+    auto const count = size_t(std::size(values));
+    if (count < 2)
+        return;
+    CC_ASSERT(count <= size_t(UINT32_MAX) && "too many elements");
+
+    auto const key_size = detail::radix_key_size(data[0]);
+    detail::radix_sort_impl<T>(data, count, key_size, detail::radix_thread_count(mode, count),
+                               [](T const& v, std::byte*& dst) { detail::write_radix_key(v, dst); });
+}
+
+/// sorts the contiguous range values by the given members (the first member is the primary key)
+template <class Range, class T, class... Ms>
+void radix_sort_by(Range& values, radix_sort_mode mode, Ms T::*... members)
+{
+    static_assert(detail::is_contiguous_range_t<Range>::value, "values must be a contiguous range");
+    static_assert(std::is_same_v<T, detail::range_element_t<Range>>, "members must belong to the element type");
+    static_assert(sizeof...(Ms) > 0, "at least one member is required");
+
+    auto const data = std::data(values);
+    auto const count = size_t(std::size(values));
+    if (count < 2)
+        return;
+    CC_ASSERT(count <= size_t(UINT32_MAX) && "too many elements");
+
+    auto const key_size = (size_t(0) + ... + detail::radix_key_size(data[0].*members));
+    detail::radix_sort_impl<T>(data, count, key_size, detail::radix_thread_count(mode, count),
+                               [members...](T const& v, std::byte*& dst) { (detail::write_radix_key(v.*members, dst), ...); });
+}
+
+template <class Range, class T, class... Ms>
+void radix_sort_by(Range& values, Ms T::*... members)
+{
+    rf::radix_sort_by(values, radix_sort_mode::sequential, members...);
+}
+}
@@ -0,0 +1,100 @@
+#include <reflector/registry.hh>
+
+#include <atomic>
+
+#include <clean-core/vector.hh>
+
+namespace
+{
+struct registry_data
+{
+    cc::vector<rf::type_descriptor const*> by_id; ///< indexed by type id, nullptr if not registered
+    cc::vector<rf::type_descriptor const*> types; ///< in registration order
+
+    // name lookup: open-addressing table over the names of types
+    cc::vector<cc::string_view> names;
+    cc::vector<rf::detail::string_table_entry> entries;
+    size_t capacity = 0;
+};
+
+/// NOTE: function-local static so that registrations during static initialization of other TUs are safe
+registry_data& registry()
+{
+    static registry_data r;
+    return r;
+}
+
+void rebuild_name_table(registry_data& r)
+{
+    r.capacity = rf::detail::string_table_capacity(r.names.size() * 2); // grow in steps to amortize rebuilds
+    r.entries.clear();
+    r.entries.resize(r.capacity);
+    for (size_t i = 0; i < r.names.size(); ++i)
+        rf::detail::string_table_insert<true>(r.entries, r.capacity, r.names, uint32_t(i));
+}
+}
+
+rf::type_id rf::detail::allocate_type_id()
+{
+    static std::atomic<type_id> next_id = 0;
+    return next_id++;
+}
+
+void rf::detail::add_registered_type(type_descriptor const& desc)
+{
+    auto& r = registry();
+    CC_ASSERT(find_type(desc.name) == nullptr && "a different type is already registered under this name");
+    // the name hash must identify a type unambiguously (see find_type_by_name_hash)
+    CC_ASSERT(find_type_by_name_hash(desc.name_hash) == nullptr && "type name hash collision, rename one of the types");
+
+    if (r.by_id.size() <= desc.id)
+        r.by_id.resize(desc.id + 1, nullptr);
+    r.by_id[desc.id] = &desc;
+
+    r.types.push_back(&desc);
+    r.names.push_back(desc.name);
+
+    if (2 * r.names.size() > r.capacity)
+        rebuild_name_table(r);
+    else
+        string_table_insert<true>(r.entries, r.capacity, r.names, uint32_t(r.names.size() - 1));
+}
+
+rf::type_descriptor const* rf::find_type(type_id id)
+{
+    auto const& r = registry();
+    return id < r.by_id.size() ? r.by_id[id] : nullptr;
+}
+
+rf::type_descriptor const* rf::find_type(cc::string_view name)
+{
+    auto const& r = registry();
+    if (r.capacity == 0)
+        return nullptr;
+
+    auto const idx = detail::string_table_find<true>(r.entries, r.capacity, r.names, name);
+    return idx < 0 ? nullptr : r.types[idx];
+}
+
+rf::type_descriptor const* rf::find_type_by_name_hash(uint32_t name_hash)
+{
+    auto const& r = registry();
+    if (r.capacity == 0)
+        return nullptr;
+
+    // same probing as detail::string_table_find, but without the string compare
+    auto i = name_hash & (r.capacity - 1);
+    while (r.entries[i].index != detail::string_table_entry::empty_index)
+    {
+        if (r.entries[i].hash == name_hash)
+            return r.types[r.entries[i].index];
+        i = (i + 1) & (r.capacity - 1);
+    }
+    return nullptr;
+}
+
+cc::span<rf::type_descriptor const* const> rf::registered_types()
+{
+    auto const& r = registry();
+    return {r.types.data(), r.types.size()};
+}
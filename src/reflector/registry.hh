@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <clean-core/assert.hh>
+#include <clean-core/has_operator.hh>
+#include <clean-core/span.hh>
+#include <clean-core/string.hh>
+#include <clean-core/string_view.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/compare.hh>
+#include <reflector/detail/string_table.hh>
+#include <reflector/hash.hh>
+#include <reflector/introspect.hh>
+#include <reflector/macros.hh>
+#include <reflector/members.hh>
+#include <reflector/to_string.hh>
+
+namespace rf
+{
+/**
+ * Opt-in runtime type registry (type erasure for tooling that does not know the types at compile time)
+ *
+ * rf::register_type<T>(name) computes a flat descriptor of T once: one record per member
+ * (name, offset, size, type id, and type-erased to_string/hash/equal functions)
+ * Generic code can then walk registered objects via void pointers without any template instantiation at the use site
+ *
+ * Lookup is O(1) by type id (a dense array) and by type name or type name hash (an open-addressing hash table)
+ *
+ * NOTE: registration is not thread-safe, register all types during startup (e.g. via REFL_REGISTER_TYPE) before lookups
+ *       descriptors are never moved or freed, references to them stay valid
+ *       type names must outlive the registry (e.g. string literals)
+ *       members of registered types are not registered automatically (their type ids can still be looked up once they are)
+ *
+ * Usage example:
+ *
+ *   REFL_REGISTER_TYPE(my_struct); // at namespace scope in some .cc
+ *
+ *   void print(void const* obj, rf::type_id type)
+ *   {
+ *       auto const desc = rf::find_type(type);
+ *       for (auto const& m : desc->members)
+ *       {
+ *           cc::string s;
+ *           m.functions.to_string(s, m.get(obj));
+ *           LOG("{}: {}", m.name, s);
+ *       }
+ *   }
+ */
+
+using type_id = uint32_t;
+
+inline constexpr type_id invalid_type_id = ~type_id(0);
+
+/// type-erased operations on a value, nullptr if not supported by the type
+struct type_functions
+{
+    void (*to_string)(cc::string& s, void const* v) = nullptr; ///< appends the value (rf::write_to)
+    uint64_t (*hash)(void const* v) = nullptr;                 ///< rf::make_hash
+    bool (*equal)(void const* lhs, void const* rhs) = nullptr; ///< rf::is_equal
+};
+
+struct member_descriptor
+{
+    cc::string_view name;
+    size_t offset = 0; ///< byte offset relative to the start of the object
+    size_t size = 0;   ///< sizeof(member)
+    type_id type = invalid_type_id;
+    type_functions functions;
+
+    void const* get(void const* obj) const { return static_cast<std::byte const*>(obj) + offset; }
+    void* get(void* obj) const { return static_cast<std::byte*>(obj) + offset; }
+};
+
+struct type_descriptor
+{
+    cc::string_view name;
+    uint32_t name_hash = 0; ///< rf::hash_type_name(name)
+    type_id id = invalid_type_id;
+    size_t size = 0;
+    size_t alignment = 0;
+    type_functions functions;
+    cc::span<member_descriptor const> members; ///< in introspect order
+};
+
+/// unique id of T (assigned on first use, ids are dense and start at 0)
+/// NOTE: all types get ids, not only registered ones
+template <class T>
+type_id type_id_of();
+
+/// registers T under the given name and returns its descriptor
+/// registering a type multiple times is allowed and returns the same descriptor (the name must then be the same)
+/// NOTE: T must be default constructible (member offsets are computed from a default-constructed object)
+template <class T>
+type_descriptor const& register_type(cc::string_view name);
+
+/// the hash used for lookups by name (stable, i.e. can be sent over the network)
+inline uint32_t hash_type_name(cc::string_view name) { return detail::string_hash<true>(name); }
+
+/// returns the descriptor of a registered type or nullptr if not registered
+/// NOTE: name hashes of registered types are unique (registration asserts that there is no collision),
+///       so a name hash identifies a type just like its name
+[[nodiscard]] type_descriptor const* find_type(type_id id);
+[[nodiscard]] type_descriptor const* find_type(cc::string_view name);
+[[nodiscard]] type_descriptor const* find_type_by_name_hash(uint32_t name_hash);
+
+template <class T>
+[[nodiscard]] type_descriptor const* find_type()
+{
+    return rf::find_type(rf::type_id_of<T>());
+}
+
+/// all registered types in registration order
+/// NOTE: the span is invalidated by further registrations
+[[nodiscard]] cc::span<type_descriptor const* const> registered_types();
+
+/// registers a type during static initialization
+/// Usage (at namespace scope, not in a header): REFL_REGISTER_TYPE(my_namespace::my_struct);
+#define REFL_REGISTER_TYPE(Type)                                                                          \
+    [[maybe_unused]] static ::rf::type_descriptor const& REFL_IMPL_MACRO_PASTE(rf_registered_type_, __LINE__) \
+        = ::rf::register_type<Type>(#Type)
+
+
+// ==================================================
+// implementation details:
+
+namespace detail
+{
+type_id allocate_type_id();
+
+void add_registered_type(type_descriptor const& desc);
+
+template <class T>
+type_functions make_type_functions()
+{
+    type_functions f;
+    if constexpr (rf::has_to_string<T>)
+        f.to_string = [](cc::string& s, void const* v) { rf::write_to(s, *static_cast<T const*>(v)); };
+    if constexpr (rf::can_hash<T>)
+        f.hash = [](void const* v) -> uint64_t { return rf::make_hash(*static_cast<T const*>(v)); };
+    if constexpr (cc::has_operator_equal<T, T> || rf::is_introspectable<T>)
+        f.equal = [](void const* lhs, void const* rhs) { return rf::is_equal(*static_cast<T const*>(lhs), *static_cast<T const*>(rhs)); };
+    return f;
+}
+
+/// like MemberInfoBuilder, but without a compile-time member count (i.e. also for non-literal types)
+/// NOTE: offsets are filled in from rf::member_offsets
+struct MemberDescriptorBuilder
+{
+    cc::vector<member_descriptor>& members;
+
+    template <class M, class... Args>
+    void operator()(M const&, cc::string_view name, Args&&...)
+    {
+        auto& m = members.emplace_back();
+        m.name = name;
+        m.size = sizeof(M);
+        m.type = rf::type_id_of<M>();
+        m.functions = make_type_functions<M>();
+    }
+};
+
+struct registered_type
+{
+    type_descriptor desc;
+    cc::vector<member_descriptor> members;
+};
+}
+
+template <class T>
+type_id type_id_of()
+{
+    static_assert(std::is_same_v<T, std::remove_cv_t<std::remove_reference_t<T>>>, "type ids are only assigned to unqualified types");
+    static type_id const id = detail::allocate_type_id();
+    return id;
+}
+
+template <class T>
+type_descriptor const& register_type(cc::string_view name)
+{
+    static_assert(rf::is_introspectable<T>, "only introspectable types can be registered");
+
+    // NOTE: function-local statics are initialized in order, even during static initialization
+    static detail::registered_type storage;
+    static bool const is_registered = [name]
+    {
+        auto const& offsets = rf::member_offsets<T>();
+        CC_ASSERT(offsets.is_valid && "all introspected members must be subobjects");
+
+        T t = {};
+        rf::do_introspect(detail::MemberDescriptorBuilder{storage.members}, t);
+        for (size_t i = 0; i < storage.members.size(); ++i)
+            storage.members[i].offset = offsets[i];
+
+        auto& d = storage.desc;
+        d.name = name;
+        d.name_hash = rf::hash_type_name(name);
+        d.id = rf::type_id_of<T>();
+        d.size = sizeof(T);
+        d.alignment = alignof(T);
+        d.functions = detail::make_type_functions<T>();
+        d.members = cc::span<member_descriptor const>(storage.members.data(), storage.members.size());
+        detail::add_registered_type(d);
+        return true;
+    }();
+    (void)is_registered;
+
+    CC_ASSERT(storage.desc.name == name && "type already registered under a different name");
+    return storage.desc;
+}
+}
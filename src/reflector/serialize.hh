@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include <clean-core/assert.hh>
+#include <clean-core/span.hh>
+
+#include <reflector/detail/serialize.hh>
+
+namespace rf
+{
+/**
+ * Introspection-based binary serialization
+ *
+ * Writers provide `void write(void const* data, size_t size)`
+ * Readers provide `bool read(void* data, size_t size)` (returning false if not enough data is available)
+ *         and optionally `size_t remaining() const` (used to reject corrupted range sizes before allocating)
+ *
+ * Format:
+ *   - arithmetic types and enums: their object representation
+ *   - introspectable types: their introspected members in order
+ *     (members that exactly tile the object without padding are written as a single block,
+ *      this needs a constexpr introspect, otherwise the members are written one by one with the same result)
+ *   - ranges: uint64_t element count followed by the elements
+ *     (contiguous ranges of bytewise types are written as a single block)
+ *
+ * NOTE: the format uses the native endianness and type sizes and is not versioned
+ *       it is meant for snapshots and transfers between identical builds
+ *       deserialization assumes trusted input (e.g. enums and bools are not validated)
+ *
+ * Usage example:
+ *
+ *   rf::byte_writer writer;
+ *   rf::serialize(writer, my_value);
+ *
+ *   auto reader = rf::byte_reader(writer.data());
+ *   my_type v;
+ *   if (!rf::deserialize(reader, v))
+ *       ... // error handling
+ */
+
+/// writer that appends to an owned, growable byte buffer
+class byte_writer
+{
+public:
+    byte_writer() = default;
+    byte_writer(byte_writer const&) = delete;
+    byte_writer& operator=(byte_writer const&) = delete;
+    byte_writer(byte_writer&& rhs) noexcept : _data(rhs._data), _size(rhs._size), _capacity(rhs._capacity)
+    {
+        rhs._data = nullptr;
+        rhs._size = 0;
+        rhs._capacity = 0;
+    }
+    byte_writer& operator=(byte_writer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            delete[] _data;
+            _data = rhs._data;
+            _size = rhs._size;
+            _capacity = rhs._capacity;
+            rhs._data = nullptr;
+            rhs._size = 0;
+            rhs._capacity = 0;
+        }
+        return *this;
+    }
+    ~byte_writer() { delete[] _data; }
+
+    void write(void const* data, size_t size)
+    {
+        if (_size + size > _capacity)
+            grow(_size + size);
+        std::memcpy(_data + _size, data, size);
+        _size += size;
+    }
+
+    /// overwrites previously written bytes
+    void write_at(size_t offset, void const* data, size_t size)
+    {
+        CC_ASSERT(offset + size <= _size && "can only overwrite already written bytes");
+        std::memcpy(_data + offset, data, size);
+    }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > _capacity)
+            grow(capacity);
+    }
+
+    void clear() { _size = 0; }
+
+    [[nodiscard]] cc::span<std::byte const> data() const { return {_data, _size}; }
+    [[nodiscard]] size_t size() const { return _size; }
+
+private:
+    void grow(size_t min_capacity)
+    {
+        auto new_capacity = _capacity < 64 ? size_t(64) : _capacity * 2;
+        if (new_capacity < min_capacity)
+            new_capacity = min_capacity;
+
+        auto const new_data = new std::byte[new_capacity]; // intentionally uninitialized
+        if (_size > 0)
+            std::memcpy(new_data, _data, _size);
+        delete[] _data;
+        _data = new_data;
+        _capacity = new_capacity;
+    }
+
+    std::byte* _data = nullptr;
+    size_t _size = 0;
+    size_t _capacity = 0;
+};
+
+/// reader over a borrowed byte span
+class byte_reader
+{
+public:
+    explicit byte_reader(cc::span<std::byte const> data) : _data(data) {}
+
+    [[nodiscard]] bool read(void* data, size_t size)
+    {
+        if (size > remaining())
+            return false;
+        std::memcpy(data, _data.data() + _pos, size);
+        _pos += size;
+        return true;
+    }
+
+    [[nodiscard]] size_t remaining() const { return _data.size() - _pos; }
+    [[nodiscard]] size_t position() const { return _pos; }
+
+private:
+    cc::span<std::byte const> _data;
+    size_t _pos = 0;
+};
+
+/// true iff T can be serialized (i.e. is arithmetic, an enum, introspectable, or a range of serializable elements)
+template <class T>
+static constexpr bool can_serialize = detail::can_serialize_t<T>::value;
+
+/// writes value to the writer
+template <class Writer, class T>
+void serialize(Writer& writer, T const& value)
+{
+    static_assert(can_serialize<T>, "type cannot be serialized");
+    detail::impl_serialize(writer, value);
+}
+
+/// reads value from the reader
+/// returns false if the reader ran out of data or a fixed-size range did not match
+/// (value might be partially overwritten in that case)
+template <class Reader, class T>
+[[nodiscard]] bool deserialize(Reader& reader, T& value)
+{
+    static_assert(can_serialize<T>, "type cannot be deserialized");
+    return detail::impl_deserialize(reader, value);
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include <clean-core/string_view.hh>
+
+namespace rf
+{
+/**
+ * A sink is the destination of streaming text output (e.g. rf::write_to)
+ *
+ * Supported sinks:
+ *   - anything with `void append(char const* data, size_t size)` (e.g. rf::buffer_sink, file or ring buffers)
+ *   - anything supporting `sink += cc::string_view` (e.g. cc::string)
+ *
+ * Usage example:
+ *
+ *   char buffer[256];
+ *   auto sink = rf::buffer_sink(buffer);
+ *   rf::write_to(sink, my_value);
+ *   LOG("{}", sink.written());
+ */
+
+/// sink that writes into a caller-owned, fixed-size char buffer
+/// NOTE: output that does not fit is dropped (check is_truncated())
+///       the result is NOT zero-terminated
+struct buffer_sink
+{
+    buffer_sink(char* data, size_t capacity) : _data(data), _capacity(capacity) {}
+
+    template <size_t N>
+    buffer_sink(char (&buffer)[N]) : _data(buffer), _capacity(N)
+    {
+    }
+
+    void append(char const* data, size_t size)
+    {
+        auto const free = _capacity - _size;
+        if (size > free)
+        {
+            _truncated = true;
+            size = free;
+        }
+        std::memcpy(_data + _size, data, size);
+        _size += size;
+    }
+
+    [[nodiscard]] cc::string_view written() const { return {_data, _size}; }
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] size_t capacity() const { return _capacity; }
+    [[nodiscard]] bool is_truncated() const { return _truncated; }
+
+    void clear()
+    {
+        _size = 0;
+        _truncated = false;
+    }
+
+private:
+    char* _data;
+    size_t _capacity;
+    size_t _size = 0;
+    bool _truncated = false;
+};
+
+namespace detail
+{
+template <class Sink, class = void>
+struct has_sink_append_t : std::false_type
+{
+};
+template <class Sink>
+struct has_sink_append_t<Sink, std::void_t<decltype(std::declval<Sink&>().append(std::declval<char const*>(), size_t(0)))>> : std::true_type
+{
+};
+
+template <class Sink>
+void sink_append(Sink& sink, cc::string_view s)
+{
+    if constexpr (has_sink_append_t<Sink>::value)
+        sink.append(s.data(), s.size());
+    else
+        sink += s;
+}
+
+template <class Sink>
+void sink_append(Sink& sink, char c)
+{
+    sink_append(sink, cc::string_view(&c, 1));
+}
+}
+}
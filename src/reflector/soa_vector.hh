@@ -0,0 +1,380 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include <clean-core/assert.hh>
+#include <clean-core/span.hh>
+#include <clean-core/string_view.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/detail/soa_layout.hh>
+#include <reflector/introspect.hh>
+
+namespace rf
+{
+/**
+ * A struct-of-arrays container for introspectable types
+ *
+ * Every introspected member of T is stored in its own contiguous array (a "column"),
+ * aligned to at least rf::detail::soa_column_alignment bytes
+ * Passes that only touch a few members thus only load those members and can be vectorized per column
+ *
+ * Columns are accessed by member pointer, index (in introspection order), or name
+ * Whole elements are reassembled on demand via get(i) or the operator[] proxy
+ *
+ * NOTE: T must be default constructible and all introspected members must be subobjects of T
+ *       members that are not introspected are not stored (and are default-initialized when reassembling)
+ *       the column layout is computed once per type (from a default-constructed T)
+ *
+ * Usage example:
+ *
+ *   rf::soa_vector<particle> particles;
+ *   particles.push_back({pos, vel, mass});
+ *
+ *   auto pos = particles.column(&particle::pos);
+ *   auto vel = particles.column(&particle::vel);
+ *   for (size_t i = 0; i < particles.size(); ++i)
+ *       pos[i] += vel[i] * dt;
+ *
+ *   particle p = particles[3];
+ *   particles[4] = p;
+ */
+template <class T>
+class soa_vector
+{
+    static_assert(rf::is_introspectable<T>, "soa_vector requires an introspectable type");
+
+    using layout_t = detail::soa_layout<T>;
+
+public:
+    /// proxy for a single element (reassembled from the columns on read)
+    class element_ref
+    {
+    public:
+        operator T() const { return _vec->get(_idx); }
+
+        element_ref& operator=(T const& value)
+        {
+            _vec->set(_idx, value);
+            return *this;
+        }
+
+        /// direct access to a single member of the element
+        template <class M>
+        M& operator[](M T::*member) const
+        {
+            return _vec->column(member)[_idx];
+        }
+
+    private:
+        element_ref(soa_vector* vec, size_t idx) : _vec(vec), _idx(idx) {}
+
+        soa_vector* _vec;
+        size_t _idx;
+
+        friend class soa_vector;
+    };
+
+    // ctors / assignment
+public:
+    soa_vector() = default;
+    explicit soa_vector(size_t size) { resize(size); }
+
+    soa_vector(soa_vector const& rhs)
+    {
+        if (rhs._size == 0)
+            return;
+
+        reserve(rhs._size);
+        auto const& cols = layout().columns;
+        for (size_t c = 0; c < cols.size(); ++c)
+            cols[c].ops->copy_construct(_columns[c], rhs._columns[c], rhs._size);
+        _size = rhs._size;
+    }
+    soa_vector(soa_vector&& rhs) noexcept : _columns(std::move(rhs._columns)), _size(rhs._size), _capacity(rhs._capacity)
+    {
+        rhs._columns = {};
+        rhs._size = 0;
+        rhs._capacity = 0;
+    }
+    soa_vector& operator=(soa_vector const& rhs)
+    {
+        if (this != &rhs)
+            *this = soa_vector(rhs);
+        return *this;
+    }
+    soa_vector& operator=(soa_vector&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            free_storage();
+            _columns = std::move(rhs._columns);
+            _size = rhs._size;
+            _capacity = rhs._capacity;
+            rhs._columns = {};
+            rhs._size = 0;
+            rhs._capacity = 0;
+        }
+        return *this;
+    }
+    ~soa_vector() { free_storage(); }
+
+    // properties
+public:
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] size_t capacity() const { return _capacity; }
+    [[nodiscard]] bool empty() const { return _size == 0; }
+
+    /// number of columns (i.e. introspected members of T)
+    [[nodiscard]] static size_t column_count() { return layout().columns.size(); }
+
+    /// returns the column index of the member with the given name or -1 if not found
+    [[nodiscard]] static int column_index(cc::string_view name) { return layout().find(name); }
+
+    /// returns the column index of the member or -1 if it is not introspected
+    template <class M>
+    [[nodiscard]] static int column_index(M T::*member)
+    {
+        return layout().find(member);
+    }
+
+    /// returns the member name of the given column
+    [[nodiscard]] static cc::string_view column_name(size_t column) { return layout().columns[column].name; }
+
+    // column access
+public:
+    template <class M>
+    [[nodiscard]] cc::span<M> column(M T::*member)
+    {
+        auto const idx = column_index(member);
+        CC_ASSERT(idx >= 0 && "member is not introspected");
+        return {reinterpret_cast<M*>(column_data(size_t(idx))), _size};
+    }
+    template <class M>
+    [[nodiscard]] cc::span<M const> column(M T::*member) const
+    {
+        auto const idx = column_index(member);
+        CC_ASSERT(idx >= 0 && "member is not introspected");
+        return {reinterpret_cast<M const*>(column_data(size_t(idx))), _size};
+    }
+
+    /// NOTE: M must be the exact member type of the column
+    template <class M>
+    [[nodiscard]] cc::span<M> column(size_t idx)
+    {
+        check_column_type<M>(idx);
+        return {reinterpret_cast<M*>(column_data(idx)), _size};
+    }
+    template <class M>
+    [[nodiscard]] cc::span<M const> column(size_t idx) const
+    {
+        check_column_type<M>(idx);
+        return {reinterpret_cast<M const*>(column_data(idx)), _size};
+    }
+
+    template <class M>
+    [[nodiscard]] cc::span<M> column(cc::string_view name)
+    {
+        auto const idx = column_index(name);
+        CC_ASSERT(idx >= 0 && "no member with this name");
+        return column<M>(size_t(idx));
+    }
+    template <class M>
+    [[nodiscard]] cc::span<M const> column(cc::string_view name) const
+    {
+        auto const idx = column_index(name);
+        CC_ASSERT(idx >= 0 && "no member with this name");
+        return column<M>(size_t(idx));
+    }
+
+    // element access
+public:
+    [[nodiscard]] element_ref operator[](size_t i)
+    {
+        CC_ASSERT(i < _size && "out of bounds");
+        return {this, i};
+    }
+    [[nodiscard]] T operator[](size_t i) const { return get(i); }
+
+    /// reassembles element i
+    [[nodiscard]] T get(size_t i) const
+    {
+        CC_ASSERT(i < _size && "out of bounds");
+        T value = {};
+        auto const raw = reinterpret_cast<std::byte*>(&value);
+        auto const& cols = layout().columns;
+        for (size_t c = 0; c < cols.size(); ++c)
+            cols[c].ops->copy_assign(raw + cols[c].offset, _columns[c] + i * cols[c].size, 1);
+        return value;
+    }
+
+    /// overwrites all introspected members of element i
+    void set(size_t i, T const& value)
+    {
+        CC_ASSERT(i < _size && "out of bounds");
+        auto const raw = reinterpret_cast<std::byte const*>(&value);
+        auto const& cols = layout().columns;
+        for (size_t c = 0; c < cols.size(); ++c)
+            cols[c].ops->copy_assign(_columns[c] + i * cols[c].size, raw + cols[c].offset, 1);
+    }
+
+    // modification
+public:
+    void push_back(T const& value)
+    {
+        grow_for(_size + 1);
+        auto const raw = reinterpret_cast<std::byte const*>(&value);
+        auto const& cols = layout().columns;
+        for (size_t c = 0; c < cols.size(); ++c)
+            cols[c].ops->copy_construct(_columns[c] + _size * cols[c].size, raw + cols[c].offset, 1);
+        ++_size;
+    }
+    void push_back(T&& value)
+    {
+        grow_for(_size + 1);
+        auto const raw = reinterpret_cast<std::byte*>(&value);
+        auto const& cols = layout().columns;
+        for (size_t c = 0; c < cols.size(); ++c)
+            cols[c].ops->move_construct(_columns[c] + _size * cols[c].size, raw + cols[c].offset, 1);
+        ++_size;
+    }
+
+    void pop_back()
+    {
+        CC_ASSERT(_size > 0 && "empty soa_vector");
+        --_size;
+        auto const& cols = layout().columns;
+        for (size_t c = 0; c < cols.size(); ++c)
+            cols[c].ops->destroy(_columns[c] + _size * cols[c].size, 1);
+    }
+
+    /// removes element i, keeping the order of the remaining elements
+    void erase(size_t i)
+    {
+        CC_ASSERT(i < _size && "out of bounds");
+        auto const& cols = layout().columns;
+        for (size_t c = 0; c < cols.size(); ++c)
+        {
+            auto const col = _columns[c];
+            auto const s = cols[c].size;
+            cols[c].ops->move_assign_forward(col + i * s, col + (i + 1) * s, _size - i - 1);
+            cols[c].ops->destroy(col + (_size - 1) * s, 1);
+        }
+        --_size;
+    }
+
+    /// removes element i by moving the last element into its place (O(1), does not keep the order)
+    void erase_unordered(size_t i)
+    {
+        CC_ASSERT(i < _size && "out of bounds");
+        if (i + 1 < _size)
+        {
+            auto const& cols = layout().columns;
+            for (size_t c = 0; c < cols.size(); ++c)
+            {
+                auto const s = cols[c].size;
+                cols[c].ops->move_assign_forward(_columns[c] + i * s, _columns[c] + (_size - 1) * s, 1);
+            }
+        }
+        pop_back();
+    }
+
+    /// new elements are value-initialized
+    void resize(size_t new_size)
+    {
+        auto const& cols = layout().columns;
+        if (new_size > _size)
+        {
+            grow_for(new_size);
+            for (size_t c = 0; c < cols.size(); ++c)
+                cols[c].ops->default_construct(_columns[c] + _size * cols[c].size, new_size - _size);
+        }
+        else if (new_size < _size)
+        {
+            // NOTE: _size > 0 here, so the columns are allocated
+            for (size_t c = 0; c < cols.size(); ++c)
+                cols[c].ops->destroy(_columns[c] + new_size * cols[c].size, _size - new_size);
+        }
+        _size = new_size;
+    }
+
+    void clear() { resize(0); }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > _capacity)
+            reallocate(capacity);
+    }
+
+    // helper
+private:
+    static layout_t const& layout() { return layout_t::get(); }
+
+    std::byte* column_data(size_t column) const
+    {
+        CC_ASSERT(column < column_count() && "out of bounds");
+        return _capacity > 0 ? _columns[column] : nullptr;
+    }
+
+    template <class M>
+    static void check_column_type(size_t column)
+    {
+        CC_ASSERT(column < column_count() && "out of bounds");
+        CC_ASSERT(layout().columns[column].type == &detail::soa_type_tag<M> && "wrong member type for this column");
+    }
+
+    void grow_for(size_t min_capacity)
+    {
+        if (min_capacity <= _capacity)
+            return;
+
+        auto new_capacity = _capacity < 16 ? size_t(16) : _capacity * 2;
+        if (new_capacity < min_capacity)
+            new_capacity = min_capacity;
+        reallocate(new_capacity);
+    }
+
+    void reallocate(size_t new_capacity)
+    {
+        auto const& cols = layout().columns;
+        if (_columns.empty())
+            _columns.resize(cols.size());
+
+        for (size_t c = 0; c < cols.size(); ++c)
+        {
+            auto const& col = cols[c];
+            auto const new_data = detail::soa_allocate(new_capacity * col.size, col.alignment);
+            if (_capacity > 0)
+            {
+                col.ops->move_construct(new_data, _columns[c], _size);
+                col.ops->destroy(_columns[c], _size);
+                detail::soa_free(_columns[c], col.alignment);
+            }
+            _columns[c] = new_data;
+        }
+        _capacity = new_capacity;
+    }
+
+    void free_storage()
+    {
+        if (_capacity == 0)
+            return;
+
+        auto const& cols = layout().columns;
+        for (size_t c = 0; c < cols.size(); ++c)
+        {
+            cols[c].ops->destroy(_columns[c], _size);
+            detail::soa_free(_columns[c], cols[c].alignment);
+        }
+        _size = 0;
+        _capacity = 0;
+    }
+
+    // member
+private:
+    cc::vector<std::byte*> _columns; ///< one array per introspected member (empty until the first allocation)
+    size_t _size = 0;
+    size_t _capacity = 0;
+};
+}
@@ -16,15 +16,31 @@ static constexpr bool has_to_string = ::rf_external_detail::has_to_string_t<T>::
 /// * cc::to_string(value)
 /// * introspect(..., value)
 ///
-/// TODO: implement stream-based version for better performance
+/// NOTE: use rf::write_to to append to an existing sink instead
 template <class T, cc::enable_if<has_to_string<T>> = true>
 cc::string to_string(T const& value)
 {
-    auto s = ::rf_external_detail::impl_to_string(value, ::rf_external_detail::to_string_max_prio);
+    cc::string s;
+    ::rf_external_detail::impl_to_string(s, value, ::rf_external_detail::to_string_max_prio);
+    return s;
+}
 
-    if constexpr (std::is_same_v<decltype(s), cc::string>)
-        return s;
-    else
-        return cc::string(cc::string_view(s));
+/// streaming version of rf::to_string
+/// appends the string representation of value to the sink (see reflector/sink.hh)
+/// nested members, ranges, and enums are written directly without intermediate strings
+///
+/// Usage:
+///
+///   cc::string s;
+///   rf::write_to(s, a);
+///   rf::write_to(s, b);
+///
+///   char buffer[128];
+///   auto sink = rf::buffer_sink(buffer);
+///   rf::write_to(sink, c);
+template <class Sink, class T, cc::enable_if<has_to_string<T>> = true>
+void write_to(Sink& sink, T const& value)
+{
+    ::rf_external_detail::impl_to_string(sink, value, ::rf_external_detail::to_string_max_prio);
 }
 }
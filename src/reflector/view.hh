@@ -0,0 +1,399 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <clean-core/always_false.hh>
+#include <clean-core/assert.hh>
+#include <clean-core/hash.hh>
+#include <clean-core/is_range.hh>
+#include <clean-core/span.hh>
+#include <clean-core/string_view.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/detail/range_traits.hh>
+#include <reflector/detail/serialize.hh>
+#include <reflector/detail/string_table.hh>
+#include <reflector/introspect.hh>
+#include <reflector/members.hh>
+
+namespace rf
+{
+/**
+ * Zero-copy read views over reflected data
+ *
+ * rf::write_view writes an "image" of a value that can later be accessed in place via rf::view<T>
+ * (e.g. directly from an mmap'ed file or a borrowed buffer) without any allocation or copy at load time
+ *
+ * Image layout:
+ *   - a header (magic, version, layout signature of the root type, size)
+ *   - records that use the native layout of their type:
+ *     - trivially copyable members are stored as-is at their offset in the type
+ *     - introspectable members are stored as nested records at their offset
+ *     - range members are replaced by an {offset, count} pair (relative to the image start)
+ *       that refers to an out-of-line array of element records
+ *
+ * Requirements:
+ *   - the image start must be aligned to rf::view_alignment (mmap'ed memory always is)
+ *   - types must not be polymorphic and have at most rf::view_alignment alignment
+ *   - range members must be at least 16 byte large and 8 byte aligned (true for cc::vector and cc::string)
+ *   - introspectable types and types of range elements must be default constructible
+ *     (needed to compute their layout signature and member offsets)
+ *
+ * rf::open_view checks the header against the layout signature of T, so mismatching builds or types fail fast
+ *
+ * NOTE: trivially copyable members are copied as-is, pointers inside them are meaningless in the image
+ *       the layout is native (endianness, sizes, and alignments of the writing build)
+ *
+ * Usage example:
+ *
+ *   // writing
+ *   rf::byte_writer writer;
+ *   rf::write_view(writer, my_table);
+ *   // ... store writer.data() to a file
+ *
+ *   // reading (e.g. from mmap)
+ *   auto v = rf::open_view<my_table_t>(file_bytes);
+ *   if (!v.is_valid())
+ *       ... // error handling
+ *   int version = v[&my_table_t::version];            // trivially copyable members
+ *   cc::span<entry const> entries = v[&my_table_t::entries]; // ranges of trivially copyable elements
+ *   auto settings = v[&my_table_t::settings];          // nested records are views again
+ */
+
+/// required alignment of the image start
+inline constexpr size_t view_alignment = 16;
+
+template <class T>
+class view;
+
+template <class E>
+class view_array;
+
+namespace detail
+{
+struct view_header
+{
+    static constexpr uint32_t magic_value = 0x57564652; // 'RFVW'
+    static constexpr uint32_t version_value = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint64_t layout_signature;
+    uint64_t root_offset;
+    uint64_t image_size;
+};
+
+/// replaces range members in records
+struct view_range
+{
+    uint64_t offset;
+    uint64_t count;
+};
+
+enum class view_kind : uint8_t
+{
+    trivial, ///< stored as-is
+    record,  ///< introspectable, stored memberwise
+    range,   ///< stored as view_range + element records
+};
+
+template <class T>
+constexpr view_kind view_kind_of()
+{
+    static_assert(!std::is_polymorphic_v<T>, "polymorphic types cannot be viewed");
+    static_assert(alignof(T) <= rf::view_alignment, "over-aligned types cannot be viewed");
+
+    if constexpr (std::is_trivially_copyable_v<T> && (!rf::is_introspectable<T> || is_bytewise_serializable<T>))
+        return view_kind::trivial;
+    else if constexpr (rf::is_introspectable<T>)
+        return view_kind::record;
+    else if constexpr (cc::is_any_range<T>)
+    {
+        static_assert(sizeof(T) >= sizeof(view_range) && alignof(T) >= alignof(view_range), "range type too small to be replaced by a view_range");
+        return view_kind::range;
+    }
+    else if constexpr (std::is_trivially_copyable_v<T>)
+        return view_kind::trivial;
+    else
+    {
+        static_assert(cc::always_false<T>, "type cannot be viewed (must be trivially copyable, introspectable, or a range)");
+        return view_kind::trivial;
+    }
+}
+
+template <class T>
+uint64_t view_layout_signature();
+
+/// hashes the layout of the introspected members (names, offsets, sizes, kinds)
+struct ViewSignatureBuilder
+{
+    uint64_t h;
+    member_offset_table const& offsets;
+    size_t idx = 0;
+
+    template <class M, class... Args>
+    void operator()(M const&, cc::string_view name, Args&&...)
+    {
+        h = cc::hash_combine(h, string_hash<true>(name), uint64_t(offsets[idx]), view_layout_signature<M>());
+        ++idx;
+    }
+};
+
+template <class T>
+uint64_t compute_view_layout_signature()
+{
+    constexpr auto kind = view_kind_of<T>();
+    auto h = cc::hash_combine(uint64_t(kind), sizeof(T), alignof(T));
+
+    if constexpr (rf::is_introspectable<T>)
+    {
+        auto const& offsets = rf::member_offsets<T>();
+        CC_ASSERT(offsets.is_valid && "all introspected members must be subobjects");
+
+        T obj = {};
+        auto builder = ViewSignatureBuilder{h, offsets};
+        rf::do_introspect(builder, obj);
+        h = builder.h;
+    }
+    else if constexpr (kind == view_kind::range)
+        h = cc::hash_combine(h, view_layout_signature<range_element_t<T>>());
+
+    return h;
+}
+
+template <class T>
+uint64_t view_layout_signature()
+{
+    static auto const signature = compute_view_layout_signature<T>();
+    return signature;
+}
+
+class ViewImageBuilder
+{
+public:
+    /// appends zeroed, aligned storage and returns its offset
+    size_t allocate(size_t size, size_t alignment)
+    {
+        auto const old_size = buffer.size();
+        auto const offset = (old_size + alignment - 1) / alignment * alignment;
+        buffer.resize(offset + size);
+        std::memset(buffer.data() + old_size, 0, offset + size - old_size); // padding must not leak uninitialized memory
+        return offset;
+    }
+
+    void copy_to(size_t offset, void const* data, size_t size) { std::memcpy(buffer.data() + offset, data, size); }
+
+    template <class T>
+    void write_value(size_t offset, T const& v)
+    {
+        constexpr auto kind = view_kind_of<T>();
+        if constexpr (kind == view_kind::trivial)
+            copy_to(offset, &v, sizeof(T));
+        else if constexpr (kind == view_kind::record)
+        {
+            // NOTE: the offsets are checked to be subobjects when computing the layout signature
+            auto const& offsets = rf::member_offsets<T>();
+            size_t idx = 0;
+            rf::do_introspect(
+                [&](auto const& m, auto&&...)
+                {
+                    this->write_value(offset + offsets[idx], m);
+                    ++idx;
+                },
+                const_cast<T&>(v)); // promise we will not change v
+        }
+        else // range
+        {
+            using element_t = range_element_t<T>;
+            constexpr auto element_alignment = alignof(element_t) < alignof(view_range) ? alignof(view_range) : alignof(element_t);
+
+            auto const count = range_size(v);
+            auto const elements_offset = allocate(count * sizeof(element_t), element_alignment);
+
+            if constexpr (view_kind_of<element_t>() == view_kind::trivial && is_contiguous_range_t<T>::value)
+                copy_to(elements_offset, std::data(v), count * sizeof(element_t));
+            else
+            {
+                auto e_offset = elements_offset;
+                for (auto const& e : v)
+                {
+                    write_value(e_offset, e);
+                    e_offset += sizeof(element_t);
+                }
+            }
+
+            auto const r = view_range{elements_offset, count};
+            copy_to(offset, &r, sizeof(r));
+        }
+    }
+
+    cc::vector<std::byte> buffer;
+};
+
+template <class M>
+decltype(auto) make_member_view(std::byte const* image, size_t image_size, std::byte const* member);
+
+/// byte offset of a member in T, computed on a value-initialized T
+/// NOTE: the records in an image are not T objects (e.g. ranges are replaced by view_range),
+///       so the member pointer must not be applied to the record bytes directly
+template <class T, class M>
+size_t view_member_offset(M T::*member)
+{
+    static T const sample = {};
+    return size_t(reinterpret_cast<std::byte const*>(&(sample.*member)) - reinterpret_cast<std::byte const*>(&sample));
+}
+}
+
+/// a read-only view of a record of type T inside an image (see rf::write_view)
+/// NOTE: invalid views (is_valid() == false) must not be accessed
+template <class T>
+class view
+{
+public:
+    view() = default;
+    view(std::byte const* image, size_t image_size, std::byte const* record) : _image(image), _image_size(image_size), _record(record) {}
+
+    [[nodiscard]] bool is_valid() const { return _record != nullptr; }
+    explicit operator bool() const { return is_valid(); }
+
+    /// accesses a member:
+    ///   - trivially copyable members are returned as M const&
+    ///   - introspectable members are returned as rf::view<M>
+    ///   - ranges of trivially copyable elements are returned as cc::span<E const>
+    ///   - other ranges are returned as rf::view_array<E>
+    template <class M>
+    [[nodiscard]] decltype(auto) operator[](M T::*member) const
+    {
+        CC_ASSERT(is_valid());
+        // records use the native layout of T, so members are at the same offsets as in T
+        return detail::make_member_view<M>(_image, _image_size, _record + detail::view_member_offset(member));
+    }
+
+    /// the whole record, only available for trivially copyable T with a constexpr introspect
+    /// (then all members are stored as-is in the native layout, so the record bytes form a valid T)
+    [[nodiscard]] T const& value() const
+    {
+        static_assert(std::is_trivially_copyable_v<T> && detail::is_layout_analyzable<T>,
+                      "only trivially copyable types with a constexpr introspect can be accessed as a whole");
+        CC_ASSERT(is_valid());
+        return *reinterpret_cast<T const*>(_record);
+    }
+
+    [[nodiscard]] std::byte const* record_data() const { return _record; }
+
+private:
+    std::byte const* _image = nullptr;
+    size_t _image_size = 0;
+    std::byte const* _record = nullptr;
+};
+
+/// a read-only array of non-trivially stored element records inside an image
+template <class E>
+class view_array
+{
+public:
+    view_array() = default;
+    view_array(std::byte const* image, size_t image_size, std::byte const* elements, size_t count)
+      : _image(image), _image_size(image_size), _elements(elements), _count(count)
+    {
+    }
+
+    [[nodiscard]] size_t size() const { return _count; }
+    [[nodiscard]] bool empty() const { return _count == 0; }
+
+    [[nodiscard]] view<E> operator[](size_t i) const
+    {
+        CC_ASSERT(i < _count && "out of bounds");
+        return view<E>(_image, _image_size, _elements + i * sizeof(E));
+    }
+
+private:
+    std::byte const* _image = nullptr;
+    size_t _image_size = 0;
+    std::byte const* _elements = nullptr;
+    size_t _count = 0;
+};
+
+namespace detail
+{
+template <class M>
+decltype(auto) make_member_view(std::byte const* image, size_t image_size, std::byte const* member)
+{
+    constexpr auto kind = view_kind_of<M>();
+    if constexpr (kind == view_kind::trivial)
+        return *reinterpret_cast<M const*>(member);
+    else if constexpr (kind == view_kind::record)
+        return rf::view<M>(image, image_size, member);
+    else
+    {
+        using element_t = range_element_t<M>;
+
+        view_range r;
+        std::memcpy(&r, member, sizeof(r));
+
+        // corrupted ranges yield empty results instead of out-of-bounds or misaligned accesses
+        // NOTE: the image start is aligned to rf::view_alignment (>= alignof(element_t)), so aligned offsets yield aligned elements
+        auto const is_in_bounds = r.offset <= image_size && r.count <= (image_size - r.offset) / sizeof(element_t);
+        auto const is_aligned = r.offset % alignof(element_t) == 0;
+        if (!is_in_bounds || !is_aligned)
+            r = {0, 0};
+
+        auto const elements = image + r.offset;
+        if constexpr (view_kind_of<element_t>() == view_kind::trivial)
+            return cc::span<element_t const>(reinterpret_cast<element_t const*>(elements), size_t(r.count));
+        else
+            return rf::view_array<element_t>(image, image_size, elements, size_t(r.count));
+    }
+}
+}
+
+/// writes an image of value that can be accessed via rf::open_view<T>
+template <class Writer, class T>
+void write_view(Writer& writer, T const& value)
+{
+    detail::ViewImageBuilder builder;
+
+    auto const header_offset = builder.allocate(sizeof(detail::view_header), rf::view_alignment);
+    auto const root_offset = builder.allocate(sizeof(T), alignof(T));
+    builder.write_value(root_offset, value);
+
+    // pad the image so that images can be concatenated without breaking alignment
+    builder.allocate(0, rf::view_alignment);
+
+    detail::view_header header;
+    header.magic = detail::view_header::magic_value;
+    header.version = detail::view_header::version_value;
+    header.layout_signature = detail::view_layout_signature<T>();
+    header.root_offset = root_offset;
+    header.image_size = builder.buffer.size();
+    builder.copy_to(header_offset, &header, sizeof(header));
+
+    writer.write(builder.buffer.data(), builder.buffer.size());
+}
+
+/// opens a view of an image written by rf::write_view
+/// returns an invalid view if the image is misaligned, truncated, or was written for a different layout
+/// NOTE: only the header is checked, so opening is O(1) and does not touch the rest of the image
+template <class T>
+[[nodiscard]] view<T> open_view(cc::span<std::byte const> image)
+{
+    if (image.size() < sizeof(detail::view_header) || reinterpret_cast<uintptr_t>(image.data()) % rf::view_alignment != 0)
+        return {};
+
+    detail::view_header header;
+    std::memcpy(&header, image.data(), sizeof(header));
+
+    if (header.magic != detail::view_header::magic_value || header.version != detail::view_header::version_value)
+        return {};
+    if (header.layout_signature != detail::view_layout_signature<T>())
+        return {};
+    if (header.image_size > image.size() || header.root_offset % alignof(T) != 0 || header.root_offset > header.image_size
+        || header.image_size - header.root_offset < sizeof(T))
+        return {};
+
+    return view<T>(image.data(), size_t(header.image_size), image.data() + header.root_offset);
+}
+}
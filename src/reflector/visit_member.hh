@@ -0,0 +1,292 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <clean-core/array.hh>
+#include <clean-core/string_view.hh>
+#include <clean-core/vector.hh>
+
+#include <reflector/detail/string_table.hh>
+#include <reflector/introspect.hh>
+#include <reflector/members.hh>
+
+namespace rf
+{
+/**
+ * Dynamic access to a single member by index or name (e.g. for editors, scripting bindings, or RPC)
+ *
+ * fn is called as fn(member, name) (i.e. like an introspect inspector, so inspectors can be reused)
+ * returns false (without calling fn) if the index is out of range or no member has that name
+ * index is the position in introspect order (same as in rf::member_infos)
+ *
+ * Member names are looked up in a hash table and member offsets come from rf::member_offsets
+ * Per type and fn, a jump table with one function per member is built
+ * (both at compile time if T can be introspected in a constant expression, otherwise once at runtime)
+ * So an access is a table lookup (or a name hash and usually a single compare) and one indirect call
+ *
+ * NOTE: fn is instantiated for all member types, its return value is ignored
+ *       introspect functions that list non-subobjects and types that are not default constructible
+ *       are supported, but fall back to a linear search
+ *
+ * Usage example:
+ *
+ *   rf::visit_member(obj, "position", [&](auto& m, cc::string_view) {
+ *       if constexpr (std::is_same_v<std::decay_t<decltype(m)>, tg::pos3>)
+ *           m = new_position;
+ *   });
+ *
+ *   for (size_t i = 0; i < rf::get_member_count(obj); ++i)
+ *       rf::visit_member(obj, i, [&](auto const& m, cc::string_view name) { LOG("{}: {}", name, m); });
+ */
+template <class T, class Fn>
+bool visit_member(T& obj, size_t index, Fn&& fn);
+
+template <class T, class Fn>
+bool visit_member(T& obj, cc::string_view name, Fn&& fn);
+
+namespace detail
+{
+/// offsets and names of the members of a type, names are looked up in a hash table
+/// (for types without member_name_table)
+struct member_table
+{
+    cc::vector<cc::string_view> names;
+    cc::vector<size_t> offsets; ///< from rf::member_offsets
+    cc::vector<string_table_entry> entries;
+    size_t capacity = 0;
+    bool is_valid = true; ///< false if some introspected member is not a subobject
+
+    /// returns the index of the member or -1 if not found
+    int find(cc::string_view name) const { return string_table_find<true>(entries, capacity, names, name); }
+};
+
+struct MemberTableBuilder
+{
+    member_table& table;
+
+    template <class M, class... Args>
+    void operator()(M const&, cc::string_view name, Args&&...)
+    {
+        table.names.push_back(name);
+    }
+};
+
+/// returns the cached member table of T
+template <class T>
+member_table const& cached_member_table()
+{
+    static auto const table = []
+    {
+        member_table t;
+        auto const& offsets = rf::member_offsets<T>();
+        t.offsets = offsets.offsets;
+        t.is_valid = offsets.is_valid;
+
+        T obj = {};
+        rf::do_introspect(MemberTableBuilder{t}, obj);
+
+        t.capacity = string_table_capacity(t.names.size());
+        t.entries.resize(t.capacity);
+        for (size_t i = 0; i < t.names.size(); ++i)
+            string_table_insert<true>(t.entries, t.capacity, t.names, uint32_t(i));
+        return t;
+    }();
+    return table;
+}
+
+/// Obj is T or T const, members are passed with the same constness
+template <class Obj, class Fn>
+using member_visit_fn = void (*)(std::conditional_t<std::is_const_v<Obj>, void const*, void*>, cc::string_view, Fn&);
+
+template <class Obj, class M, class Fn>
+void visit_member_at(std::conditional_t<std::is_const_v<Obj>, void const*, void*> member, cc::string_view name, Fn& fn)
+{
+    using member_t = std::conditional_t<std::is_const_v<Obj>, M const, M>;
+    fn(*static_cast<member_t*>(member), name);
+}
+
+template <class Obj, class Fn>
+struct StaticMemberVisitFnBuilder
+{
+    member_visit_fn<Obj, Fn>* fns;
+
+    template <class M, class... Args>
+    constexpr void operator()(M const&, Args&&...)
+    {
+        *fns = &visit_member_at<Obj, std::remove_cv_t<M>, Fn>;
+        ++fns;
+    }
+};
+
+template <class Obj, class Fn>
+constexpr auto make_static_member_visit_fns()
+{
+    using T = std::remove_const_t<Obj>;
+    cc::array<member_visit_fn<Obj, Fn>, rf::member_count<T>> fns = {};
+    T t = {};
+    rf::do_introspect(StaticMemberVisitFnBuilder<Obj, Fn>{fns.data()}, t);
+    return fns;
+}
+
+/// the compile-time jump table for (T, Fn), entry i visits member i (used with rf::detail::member_name_table)
+template <class Obj, class Fn>
+inline constexpr auto static_member_visit_fns = make_static_member_visit_fns<Obj, Fn>();
+
+/// visits member index via the compile-time tables
+/// returns false if the index is out of range
+template <class Obj, class Fn>
+bool impl_visit_member_static(Obj& obj, member_offset_table const& offsets, size_t index, Fn& fn)
+{
+    using T = std::remove_const_t<Obj>;
+    if (index >= rf::member_count<T>)
+        return false;
+
+    using raw_t = std::conditional_t<std::is_const_v<Obj>, std::byte const, std::byte>;
+    static_member_visit_fns<Obj, Fn>[index](reinterpret_cast<raw_t*>(&obj) + offsets[index], rf::member_infos<T>[index].name, fn);
+    return true;
+}
+
+/// the jump table for (T, Fn), entry i visits member i
+template <class Obj, class Fn>
+struct member_visit_table
+{
+    struct entry
+    {
+        member_visit_fn<Obj, Fn> fn;
+        size_t offset;
+        cc::string_view name;
+    };
+
+    member_table const* members = nullptr;
+    cc::vector<entry> entries;
+};
+
+template <class Obj, class Fn>
+struct MemberVisitTableBuilder
+{
+    member_visit_table<Obj, Fn>& table;
+
+    template <class M, class... Args>
+    void operator()(M const&, Args&&...)
+    {
+        auto const i = table.entries.size();
+        table.entries.push_back({&visit_member_at<Obj, std::remove_cv_t<M>, Fn>, table.members->offsets[i], table.members->names[i]});
+    }
+};
+
+template <class Obj, class Fn>
+member_visit_table<Obj, Fn> const& cached_member_visit_table()
+{
+    using T = std::remove_const_t<Obj>;
+    static auto const table = []
+    {
+        member_visit_table<Obj, Fn> t;
+        t.members = &cached_member_table<T>();
+        if (t.members->is_valid)
+        {
+            T obj = {};
+            rf::do_introspect(MemberVisitTableBuilder<Obj, Fn>{t}, obj);
+        }
+        return t;
+    }();
+    return table;
+}
+
+/// linear fallback for introspect functions that list non-subobjects (and types that are not default constructible)
+template <class Obj, class MatchF, class Fn>
+bool visit_member_linear(Obj& obj, MatchF&& is_match, Fn& fn)
+{
+    size_t idx = 0;
+    auto found = false;
+    rf::do_introspect(
+        [&](auto& m, cc::string_view name, auto&&...)
+        {
+            if (!found && is_match(idx, name))
+            {
+                found = true;
+                if constexpr (std::is_const_v<Obj>)
+                    fn(static_cast<std::remove_reference_t<decltype(m)> const&>(m), name);
+                else
+                    fn(m, name);
+            }
+            ++idx;
+        },
+        const_cast<std::remove_const_t<Obj>&>(obj));
+    return found;
+}
+
+template <class Obj, class Fn>
+bool impl_visit_member(Obj& obj, member_visit_table<Obj, Fn> const& table, size_t index, Fn& fn)
+{
+    if (index >= table.entries.size())
+        return false;
+
+    using raw_t = std::conditional_t<std::is_const_v<Obj>, std::byte const, std::byte>;
+    auto const& e = table.entries[index];
+    e.fn(reinterpret_cast<raw_t*>(&obj) + e.offset, e.name, fn);
+    return true;
+}
+}
+
+template <class T, class Fn>
+bool visit_member(T& obj, size_t index, Fn&& fn)
+{
+    static_assert(rf::is_introspectable<std::remove_const_t<T>>, "type must be introspectable");
+
+    using F = std::remove_reference_t<Fn>;
+    auto const by_index = [index](size_t i, cc::string_view) { return i == index; };
+    if constexpr (detail::has_member_name_table<std::remove_const_t<T>>)
+    {
+        auto const& offsets = rf::member_offsets<std::remove_const_t<T>>();
+        if (!offsets.is_valid)
+            return detail::visit_member_linear(obj, by_index, fn);
+
+        return detail::impl_visit_member_static<T, F>(obj, offsets, index, fn);
+    }
+    else if constexpr (!std::is_default_constructible_v<std::remove_const_t<T>>)
+        return detail::visit_member_linear(obj, by_index, fn);
+    else
+    {
+        auto const& table = detail::cached_member_visit_table<T, F>();
+        if (!table.members->is_valid)
+            return detail::visit_member_linear(obj, by_index, fn);
+
+        return detail::impl_visit_member(obj, table, index, fn);
+    }
+}
+
+template <class T, class Fn>
+bool visit_member(T& obj, cc::string_view name, Fn&& fn)
+{
+    static_assert(rf::is_introspectable<std::remove_const_t<T>>, "type must be introspectable");
+
+    using F = std::remove_reference_t<Fn>;
+    auto const by_name = [name](size_t, cc::string_view n) { return detail::string_equals<true>(n, name); };
+    if constexpr (detail::has_member_name_table<std::remove_const_t<T>>)
+    {
+        auto const& offsets = rf::member_offsets<std::remove_const_t<T>>();
+        if (!offsets.is_valid)
+            return detail::visit_member_linear(obj, by_name, fn);
+
+        auto const idx = detail::member_name_table<std::remove_const_t<T>>.find(name);
+        if (idx < 0)
+            return false;
+        return detail::impl_visit_member_static<T, F>(obj, offsets, size_t(idx), fn);
+    }
+    else if constexpr (!std::is_default_constructible_v<std::remove_const_t<T>>)
+        return detail::visit_member_linear(obj, by_name, fn);
+    else
+    {
+        auto const& table = detail::cached_member_visit_table<T, F>();
+        if (!table.members->is_valid)
+            return detail::visit_member_linear(obj, by_name, fn);
+
+        auto const idx = table.members->find(name);
+        if (idx < 0)
+            return false;
+        return detail::impl_visit_member(obj, table, size_t(idx), fn);
+    }
+}
+}